@@ -1,86 +1,86 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Globalization;
-using System.IO;
-using System.Linq;
-using System.Net;
-using System.Text.RegularExpressions;
-using System.Web;
-
-namespace Quqe
-{
-  public static class VersaceDataFetching
-  {
-    public static void DownloadData(string predictedSymbol, DateTime start, DateTime end)
-    {
-      var dir = @"d:\users\wintonpc\git\Quqe\Share\VersaceData";
-      if (!Directory.Exists(dir))
-        Directory.CreateDirectory(dir);
-
-      foreach (var ticker in DataPreprocessing.GetTickers(predictedSymbol))
-      {
-        Console.Write("Fetching {0} ...", ticker);
-        using (var c = new WebClient())
-        {
-          var fn = Path.Combine(dir, ticker + ".txt");
-
-          if (ticker.StartsWith("^DJ")) // historical downloads of dow jones indices are not allowed
-          {
-            GetDowJonesData(c, ticker, fn, start, end);
-          }
-          else
-          {
-            var address = string.Format("http://ichart.finance.yahoo.com/table.csv?s={0}&a={1}&b={2}&c={3}&d={4}&e={5}&f={6}&g=d&ignore=.csv",
-              ticker, start.Month - 1, start.Day, start.Year, end.Month - 1, end.Day, end.Year);
-            c.DownloadFile(address, fn);
-          }
-
-          var fixedLines = File.ReadAllLines(fn).Skip(1).Reverse().Select(line => {
-            var toks = line.Split(',');
-            var timestamp = DateTime.ParseExact(toks[0], "yyyy-MM-dd", null, DateTimeStyles.AdjustToUniversal);
-            var open = double.Parse(toks[1]);
-            var high = double.Parse(toks[2]);
-            var low = double.Parse(toks[3]);
-            var close = double.Parse(toks[4]);
-            var volume = long.Parse(toks[5]);
-            return string.Format("{0:yyyyMMdd};{1};{2};{3};{4};{5}",
-              timestamp, open, high, low, close, volume);
-          });
-          File.WriteAllLines(fn, fixedLines);
-        }
-        Console.WriteLine("done");
-      }
-    }
-
-    static void GetDowJonesData(WebClient c, string ticker, string fn, DateTime start, DateTime end)
-    {
-      List<string> lines = new List<string>();
-      var address = string.Format("http://finance.yahoo.com/q/hp?s={0}&a={1}&b={2}&c={3}&d={4}&e={5}&f={6}&g=d",
-        ticker, start.Month - 1, start.Day, start.Year, end.Month - 1, end.Day, end.Year);
-
-      while (true)
-      {
-        var html = c.DownloadString(address);
-        var trs = Regex.Matches(html, @"<tr[^>]*>(<td [^>]*tabledata[^>]*>[^<]+</td>)+</tr>", RegexOptions.IgnoreCase | RegexOptions.Singleline)
-          .OfType<Match>().Select(m => m.Groups[0].Value).ToList();
-        foreach (var tr in trs)
-        {
-          var fs = Regex.Matches(tr, @"<td [^>]*tabledata[^>]*>([^<]+)</td>", RegexOptions.IgnoreCase | RegexOptions.Singleline).OfType<Match>().Select(m => m.Groups[1].Value).ToList();
-          if (fs.Count != 7)
-            continue;
-          var timestamp = DateTime.ParseExact(fs[0], "MMM d, yyyy", null, DateTimeStyles.AdjustToUniversal);
-          if (timestamp < start) // yahoo enumerates data in reverse chronological order
-            goto Done;
-          lines.Add(string.Format("{0:yyyy-MM-dd},{1},{2},{3},{4},{5}",
-            timestamp, double.Parse(fs[1]), double.Parse(fs[2]), double.Parse(fs[3]), double.Parse(fs[4]), long.Parse(fs[5], System.Globalization.NumberStyles.AllowThousands)));
-        }
-
-        var nextAddrMatch = Regex.Match(html, @"<a [^>]*href=""([^""]+)""[^>]*>Next</a>", RegexOptions.IgnoreCase | RegexOptions.Singleline);
-        if (!nextAddrMatch.Success)
-          goto Done;
-        address = "http://finance.yahoo.com" + HttpUtility.HtmlDecode(nextAddrMatch.Groups[1].Value);
-      }
-    Done: File.WriteAllLines(fn, lines);
-    }
-  }
-}
+﻿using System;
+using System.Collections.Generic;
+using System.Globalization;
+using System.IO;
+using System.Linq;
+using System.Net;
+using System.Text.RegularExpressions;
+using System.Web;
+
+namespace Quqe
+{
+  public static class VersaceDataFetching
+  {
+    public static void DownloadData(string predictedSymbol, DateTime start, DateTime end)
+    {
+      var dir = @"d:\users\wintonpc\git\Quqe\Share\VersaceData";
+      if (!Directory.Exists(dir))
+        Directory.CreateDirectory(dir);
+
+      foreach (var ticker in DataPreprocessing.GetTickers(predictedSymbol))
+      {
+        Console.Write("Fetching {0} ...", ticker);
+        using (var c = new WebClient())
+        {
+          var fn = Path.Combine(dir, ticker + ".txt");
+
+          if (ticker.StartsWith("^DJ")) // historical downloads of dow jones indices are not allowed
+          {
+            GetDowJonesData(c, ticker, fn, start, end);
+          }
+          else
+          {
+            var address = string.Format("http://ichart.finance.yahoo.com/table.csv?s={0}&a={1}&b={2}&c={3}&d={4}&e={5}&f={6}&g=d&ignore=.csv",
+              ticker, start.Month - 1, start.Day, start.Year, end.Month - 1, end.Day, end.Year);
+            c.DownloadFile(address, fn);
+          }
+
+          var fixedLines = File.ReadAllLines(fn).Skip(1).Reverse().Select(line => {
+            var toks = line.Split(',');
+            var timestamp = DateTime.ParseExact(toks[0], "yyyy-MM-dd", null, DateTimeStyles.AdjustToUniversal);
+            var open = double.Parse(toks[1]);
+            var high = double.Parse(toks[2]);
+            var low = double.Parse(toks[3]);
+            var close = double.Parse(toks[4]);
+            var volume = long.Parse(toks[5]);
+            return string.Format("{0:yyyyMMdd};{1};{2};{3};{4};{5}",
+              timestamp, open, high, low, close, volume);
+          });
+          File.WriteAllLines(fn, fixedLines);
+        }
+        Console.WriteLine("done");
+      }
+    }
+
+    static void GetDowJonesData(WebClient c, string ticker, string fn, DateTime start, DateTime end)
+    {
+      List<string> lines = new List<string>();
+      var address = string.Format("http://finance.yahoo.com/q/hp?s={0}&a={1}&b={2}&c={3}&d={4}&e={5}&f={6}&g=d",
+        ticker, start.Month - 1, start.Day, start.Year, end.Month - 1, end.Day, end.Year);
+
+      while (true)
+      {
+        var html = c.DownloadString(address);
+        var trs = Regex.Matches(html, @"<tr[^>]*>(<td [^>]*tabledata[^>]*>[^<]+</td>)+</tr>", RegexOptions.IgnoreCase | RegexOptions.Singleline)
+          .OfType<Match>().Select(m => m.Groups[0].Value).ToList();
+        foreach (var tr in trs)
+        {
+          var fs = Regex.Matches(tr, @"<td [^>]*tabledata[^>]*>([^<]+)</td>", RegexOptions.IgnoreCase | RegexOptions.Singleline).OfType<Match>().Select(m => m.Groups[1].Value).ToList();
+          if (fs.Count != 7)
+            continue;
+          var timestamp = DateTime.ParseExact(fs[0], "MMM d, yyyy", null, DateTimeStyles.AdjustToUniversal);
+          if (timestamp < start) // yahoo enumerates data in reverse chronological order
+            goto Done;
+          lines.Add(string.Format("{0:yyyy-MM-dd},{1},{2},{3},{4},{5}",
+            timestamp, double.Parse(fs[1]), double.Parse(fs[2]), double.Parse(fs[3]), double.Parse(fs[4]), long.Parse(fs[5], System.Globalization.NumberStyles.AllowThousands)));
+        }
+
+        var nextAddrMatch = Regex.Match(html, @"<a [^>]*href=""([^""]+)""[^>]*>Next</a>", RegexOptions.IgnoreCase | RegexOptions.Singleline);
+        if (!nextAddrMatch.Success)
+          goto Done;
+        address = "http://finance.yahoo.com" + HttpUtility.HtmlDecode(nextAddrMatch.Groups[1].Value);
+      }
+    Done: File.WriteAllLines(fn, lines);
+    }
+  }
+}
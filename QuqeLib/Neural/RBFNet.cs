@@ -1,189 +1,169 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Diagnostics;
-using System.Linq;
-using System.Runtime.InteropServices;
-using MathNet.Numerics.LinearAlgebra.Double;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
-
-namespace Quqe
-{
-  public class RadialBasis
-  {
-    /// <summary>Null if output bias weight</summary>
-    public readonly Vec Center;
-    public readonly double Weight;
-    public RadialBasis(Vec center, double weight)
-    {
-      Center = center;
-      Weight = weight;
-    }
-  }
-
-  public class RBFNetSolution
-  {
-    public bool IsDegenerate;
-    public readonly List<RadialBasis> Bases;
-    public RBFNetSolution(List<RadialBasis> bases, double recommendedSpread, bool isDegenerate)
-    {
-      Bases = bases;
-      IsDegenerate = isDegenerate;
-    }
-  }
-
-  public class RBFNet : IPredictor
-  {
-    public readonly List<RadialBasis> Bases;
-    public readonly double OutputBias;
-    public readonly double Spread;
-    public bool IsDegenerate { get; private set; }
-    public int NumCenters { get { return Bases.Count; } }
-
-    public RBFNet(IEnumerable<RadialBasis> bases, double outputBias, double spread, bool isDegenerate)
-    {
-      Bases = bases.ToList();
-      OutputBias = outputBias;
-      Spread = spread;
-      IsDegenerate = isDegenerate;
-    }
-
-    public static RBFNet Train(Mat trainingData, Vec outputData, double tolerance, double spread, Func<bool> cancelled = null)
-    {
-      var solution = SolveOLS(trainingData.Columns(), outputData.ToList(), tolerance, spread, cancelled); // TODO: don't call Columns
-      return new RBFNet(solution.Bases.Where(b => b.Center != null).ToList(), solution.Bases.Single(b => b.Center == null).Weight, spread, solution.IsDegenerate);
-    }
-
-    static double Phi(Vec x, Vec c, double spread)
-    {
-      return Gaussian(spread, (x - c).Norm(2));
-    }
-
-    public double Propagate(Vec x)
-    {
-      return OutputBias + Bases.Sum(b => b.Weight * Phi(x, b.Center, Spread));
-    }
-
-    public static Vec SolveLS(Mat H, Vec yHat, Action<Mat, string> showMatrix = null)
-    {
-      if (showMatrix != null) showMatrix(H, "H");
-      var Ht = H.Transpose();
-      if (showMatrix != null) showMatrix(Ht, "Ht");
-      var HtH = (Ht * H);
-      if (showMatrix != null) showMatrix(HtH, "HtH");
-      var Ainv = HtH.Inverse();
-      if (showMatrix != null) showMatrix(Ainv, "Ainv");
-      var proj = (Ainv * Ht);
-      if (showMatrix != null) showMatrix(proj, "proj");
-      return proj * yHat;
-    }
-
-    public static RBFNetSolution SolveOLS(List<Vec> xs, List<double> ys, double tolerance, double spread, Func<bool> cancelled = null)
-    {
-      Func<Vec, Vec, double> phi = (x, c) => Phi(x, c, spread);
-      var maxCenters = (int)Math.Min(xs.Count, Math.Max(1, 4 * Math.Sqrt(xs.Count)));
-      var centers = new List<Vec>(xs);
-      var n = xs.Count;
-      var m = centers.Count;
-
-      Mat P = new DenseMatrix(n, m);
-      for (int i = 0; i < n; i++)
-        for (int j = 0; j < m; j++)
-          P[i, j] = phi(xs[i], centers[j]);
-
-      Vec dOrig = new DenseVector(ys.ToArray());
-      Vec d = dOrig.Subtract(dOrig.Average());
-      Vec dNorm = d.Normalize(2);
-
-      var candidateBases = centers.Zip(P.Columns(), (ci, pi) => new { Center = ci, Basis = pi }).ToList();
-      var selectedBases = candidateBases.Select(cb => new { Center = cb.Center, Basis = cb.Basis, OrthoBasis = cb.Basis }).Take(0).ToList();
-      double qualityTotal = 0;
-
-      var context = QMCreateOrthoContext(n, m);
-      var iters = m;
-      for (int k = 0; k < iters; k++)
-      {
-        int stride = n;
-        double[] selectedOrthonormalBases = new double[selectedBases.Count * stride];
-        for (int ptr = 0, sb = 0; sb < selectedBases.Count; ptr += stride, sb++)
-          Array.Copy(selectedBases[sb].OrthoBasis.ToArray(), 0, selectedOrthonormalBases, ptr, stride);
-
-        var best = candidateBases.Select(cb => {
-          var pi = cb.Basis;
-          Vec w;
-          if (!selectedBases.Any())
-          {
-            w = pi.Normalize(2);
-          }
-          else
-          {
-            double[] result = new double[pi.Count];
-            double[] pis = pi.ToList().ToArray();
-            double[] sobs = selectedOrthonormalBases.ToList().ToArray();
-            QMOrthogonalize(context, pis, selectedBases.Count, sobs);
-            w = new DenseVector(pis.ToList().ToArray());
-          }
-          //Vec wCheck = Orthogonalize(pi, selectedBases.Select(b => b.OrthoBasis).ToList()).Normalize(2);
-          //var w = wCheck;
-          //Debug.Assert(w.Subtract(wCheck).Norm(2) < 0.0001);
-          var err = Math.Pow(w.DotProduct(dNorm), 2);
-          return new { Center = cb.Center, OrthoBasis = w, Quality = err, Candidate = cb };
-        }).OrderByDescending(q => q.Quality).First();
-        candidateBases.Remove(best.Candidate);
-        selectedBases.Add(new { Center = best.Center, Basis = best.Candidate.Basis, OrthoBasis = best.OrthoBasis });
-        qualityTotal += best.Quality;
-        if (1 - qualityTotal < tolerance || (cancelled != null && cancelled()))
-          break;
-      }
-      QMDestroyOrthoContext(context);
-
-      //Trace.WriteLine(string.Format("Centers: {0}, Spread: {1}, Tolerance: {2}", selectedBases.Count, spread, tolerance));
-
-      var weights = SolveLS(
-        new Vec[] { DenseVector.Create(n, _ => 1) }.Concat(selectedBases.Select(sb => sb.Basis)).ColumnsToMatrix(),
-        new DenseVector(ys.ToArray()));
-      bool isDegenerate = false;
-      if (weights.Any(w => double.IsNaN(w)))
-      {
-        Trace.WriteLine("! Degenerate RBF network !");
-        isDegenerate = true;
-      }
-      var allBases = selectedBases.ToList();
-      allBases.Insert(0, null);
-      var resultBases = allBases.Zip(weights, (b, w) => new RadialBasis(b != null ? b.Center : null, w)).ToList();
-      return new RBFNetSolution(resultBases, spread, isDegenerate);
-    }
-
-    [DllImport("QuqeMath.dll", EntryPoint = "CreateOrthoContext", CallingConvention = CallingConvention.Cdecl)]
-    extern static IntPtr QMCreateOrthoContext(int basisDimension, int maxBasisCount);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "DestroyOrthoContext", CallingConvention = CallingConvention.Cdecl)]
-    extern static IntPtr QMDestroyOrthoContext(IntPtr context);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "Orthogonalize", CallingConvention = CallingConvention.Cdecl)]
-    extern static void QMOrthogonalize(IntPtr c, double[] p, int n, double[] orthonormalBases);
-
-    public static Vec Orthogonalize(Vec pi, List<Vec> withRespectToNormalizedBases)
-    {
-      Vec result = pi;
-      foreach (var v in withRespectToNormalizedBases)
-        result = result - v.DotProduct(pi) * v;
-      return result;
-    }
-
-    public static double Gaussian(double stdDev, double x)
-    {
-      return Math.Exp(-Math.Pow(x / stdDev, 2));
-    }
-
-    public double Predict(Vec input)
-    {
-      return IsDegenerate ? 0 : Propagate(input);
-    }
-
-    public void Dispose()
-    {
-      // nothing to do
-    }
-  }
-}
+using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Runtime.InteropServices;
+using MathNet.Numerics.LinearAlgebra.Double;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
+
+namespace Quqe
+{
+  public class RadialBasis
+  {
+    /// <summary>Null if output bias weight</summary>
+    public readonly Vec Center;
+    public readonly double Weight;
+    public RadialBasis(Vec center, double weight)
+    {
+      Center = center;
+      Weight = weight;
+    }
+  }
+
+  public class RBFNetSolution
+  {
+    public bool IsDegenerate;
+    public readonly List<RadialBasis> Bases;
+    public RBFNetSolution(List<RadialBasis> bases, double recommendedSpread, bool isDegenerate)
+    {
+      Bases = bases;
+      IsDegenerate = isDegenerate;
+    }
+  }
+
+  public class RBFNet : ISequencePredictor
+  {
+    public readonly List<RadialBasis> Bases;
+    public readonly double OutputBias;
+    public readonly double Spread;
+    public bool IsDegenerate { get; private set; }
+    public int NumCenters { get { return Bases.Count; } }
+    readonly double[] CenterData;
+    readonly double[] WeightData;
+
+    public RBFNet(IEnumerable<RadialBasis> bases, double outputBias, double spread, bool isDegenerate)
+    {
+      Bases = bases.ToList();
+      OutputBias = outputBias;
+      Spread = spread;
+      IsDegenerate = isDegenerate;
+      CenterData = Bases.SelectMany(b => b.Center).ToArray();
+      WeightData = Bases.Select(b => b.Weight).ToArray();
+    }
+
+    public static RBFNet Train(Mat trainingData, Vec outputData, double tolerance, double spread, Func<bool> cancelled = null)
+    {
+      var solution = SolveOLS(trainingData.Columns(), outputData.ToList(), tolerance, spread, cancelled); // TODO: don't call Columns
+      return new RBFNet(solution.Bases.Where(b => b.Center != null).ToList(), solution.Bases.Single(b => b.Center == null).Weight, spread, solution.IsDegenerate);
+    }
+
+    public double Propagate(Vec x)
+    {
+      var output = new double[1];
+      QMRbfPredict(CenterData, WeightData, Bases.Count, x.Count, OutputBias, Spread, x.ToArray(), 1, 1, output);
+      return output[0];
+    }
+
+    /// <summary>Propagate for each column of inputs, in one native call</summary>
+    public Vec PropagateSequence(Mat inputs)
+    {
+      var outputs = new double[inputs.ColumnCount];
+      QMRbfPredict(CenterData, WeightData, Bases.Count, inputs.RowCount, OutputBias, Spread,
+        inputs.ToRowWiseArray(), inputs.ColumnCount, inputs.ColumnCount, outputs);
+      return new DenseVector(outputs);
+    }
+
+    public static Vec SolveLS(Mat H, Vec yHat, Action<Mat, string> showMatrix = null)
+    {
+      if (showMatrix != null) showMatrix(H, "H");
+      var Ht = H.Transpose();
+      if (showMatrix != null) showMatrix(Ht, "Ht");
+      var HtH = (Ht * H);
+      if (showMatrix != null) showMatrix(HtH, "HtH");
+      var Ainv = HtH.Inverse();
+      if (showMatrix != null) showMatrix(Ainv, "Ainv");
+      var proj = (Ainv * Ht);
+      if (showMatrix != null) showMatrix(proj, "proj");
+      return proj * yHat;
+    }
+
+    /// <summary>Orthogonal least squares: every input is a candidate center. Centers are chosen greedily,
+    /// each time the one that explains most of the remaining output variance, until all but tolerance of it
+    /// is explained. Selection and the final least squares fit run natively in QuqeMath</summary>
+    public static RBFNetSolution SolveOLS(List<Vec> xs, List<double> ys, double tolerance, double spread, Func<bool> cancelled = null)
+    {
+      var centers = xs;
+      var n = xs.Count;
+      var m = centers.Count;
+      var d = n > 0 ? xs[0].Count : 0;
+
+      // candidate basis j is column j of the design matrix, stored contiguously, which is row j of the kernel matrix
+      var inputs = new double[d * n];
+      for (int i = 0; i < n; i++)
+        for (int r = 0; r < d; r++)
+          inputs[r * n + i] = xs[i][r];
+      var candidates = new double[m * n];
+      QMGaussianKernelMatrix(centers.SelectMany(c => c).ToArray(), m, d, inputs, n, n, spread, candidates, n);
+
+      var selected = new int[m];
+      var weights = new double[m + 1];
+      int numSelected;
+      using (var cancelFlag = new RNNInterop.CancellationFlag(cancelled))
+        numSelected = QMSelectOLSBases(candidates, n, m, ys.ToArray(), tolerance, m, cancelFlag.Ptr, selected, weights);
+
+      //Trace.WriteLine(string.Format("Centers: {0}, Spread: {1}, Tolerance: {2}", numSelected, spread, tolerance));
+
+      bool isDegenerate = false;
+      if (double.IsNaN(weights[0]))
+      {
+        Trace.WriteLine("! Degenerate RBF network !");
+        isDegenerate = true;
+      }
+      var resultBases = new List<RadialBasis> { new RadialBasis(null, weights[0]) };
+      for (int s = 0; s < numSelected; s++)
+        resultBases.Add(new RadialBasis(centers[selected[s]], weights[s + 1]));
+      return new RBFNetSolution(resultBases, spread, isDegenerate);
+    }
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GaussianKernelMatrix", CallingConvention = CallingConvention.Cdecl)]
+    extern static void QMGaussianKernelMatrix(double[] centers, int m, int d, double[] inputs, int n, int ldInputs,
+      double spread, double[] k, int ldk);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "RbfPredict", CallingConvention = CallingConvention.Cdecl)]
+    extern static void QMRbfPredict(double[] centers, double[] weights, int m, int d, double outputBias, double spread,
+      double[] inputs, int n, int ldInputs, double[] outputs);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "SelectOLSBases", CallingConvention = CallingConvention.Cdecl)]
+    extern static int QMSelectOLSBases(double[] candidates, int n, int m, double[] y, double tolerance, int maxBases,
+      IntPtr cancelFlag, int[] selected, double[] weights);
+
+    public static Vec Orthogonalize(Vec pi, List<Vec> withRespectToNormalizedBases)
+    {
+      Vec result = pi;
+      foreach (var v in withRespectToNormalizedBases)
+        result = result - v.DotProduct(pi) * v;
+      return result;
+    }
+
+    public static double Gaussian(double stdDev, double x)
+    {
+      return Math.Exp(-Math.Pow(x / stdDev, 2));
+    }
+
+    public double Predict(Vec input)
+    {
+      return IsDegenerate ? 0 : Propagate(input);
+    }
+
+    public Vec PredictSequence(Mat inputs)
+    {
+      return IsDegenerate ? new DenseVector(inputs.ColumnCount) : PropagateSequence(inputs);
+    }
+
+    public void Dispose()
+    {
+      // nothing to do
+    }
+  }
+}
@@ -1,181 +1,861 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Diagnostics;
-using System.Linq;
-using System.Runtime.InteropServices;
-using MathNet.Numerics.LinearAlgebra.Double;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
-
-namespace Quqe
-{
-  public static class RNNInterop
-  {
-    const int ACTIVATION_LOGSIG = 0;
-    const int ACTIVATION_PURELIN = 1;
-
-    struct QMLayerSpec
-    {
-      public QMLayerSpec(LayerSpec spec)
-      {
-        NodeCount = spec.NodeCount;
-        IsRecurrent = spec.IsRecurrent;
-        ActivationType = spec.ActivationType == Quqe.ActivationType.LogisticSigmoid ?
-                           ACTIVATION_LOGSIG : ACTIVATION_PURELIN;
-      }
-
-      int NodeCount;
-      bool IsRecurrent;
-      int ActivationType;
-    };
-
-    public class WeightEvalInfo
-    {
-      public Vec Output;
-      public double Error;
-      public Vec Gradient;
-    }
-
-    interface IContext
-    {
-      IntPtr Ptr { get; }
-    }
-
-    public class PropagationContext : ContextBase
-    {
-      internal PropagationContext(IntPtr ptr) : base(ptr)
-      {
-      }
-
-      protected override void DestroyContext()
-      {
-        QMDestroyPropagationContext(Ptr);
-      }
-
-      public RNNSpec OriginalSpec { get; set; }
-    }
-
-    public class TrainingContext : ContextBase
-    {
-      public readonly int NumOutputs;
-
-      internal TrainingContext(IntPtr ptr, int numOutputs)
-        : base(ptr) { NumOutputs = numOutputs; }
-
-      protected override void DestroyContext() { QMDestroyTrainingContext(Ptr); }
-
-      public int InputCount { get; set; }
-      public int WeightCount { get; set; }
-    }
-
-    public abstract class ContextBase : IDisposable, IContext
-    {
-      readonly IntPtr _Ptr;
-      public IntPtr Ptr { get { return _Ptr; } }
-
-      protected ContextBase(IntPtr ptr)
-      {
-        _Ptr = ptr;
-      }
-
-      bool IsDiposed;
-
-      public void Dispose()
-      {
-        if (IsDiposed) return;
-        IsDiposed = true;
-        DestroyContext();
-      }
-
-      protected abstract void DestroyContext();
-    }
-
-    public static int GetWeightCount(List<LayerSpec> layers, int numInputs)
-    {
-      return QMGetWeightCount(Structify(layers), layers.Count, numInputs);
-    }
-
-    public static TrainingContext CreateTrainingContext(List<LayerSpec> layers, Mat trainingData, Vec outputData)
-    {
-      var ptr = QMCreateTrainingContext(Structify(layers), layers.Count, trainingData.ToRowWiseArray(), outputData.ToArray(),
-                                        trainingData.RowCount, trainingData.ColumnCount);
-      var tc = new TrainingContext(ptr, outputData.Count);
-      tc.InputCount = trainingData.RowCount;
-      tc.WeightCount = GetWeightCount(layers, trainingData.RowCount);
-      return tc;
-    }
-
-    public static WeightEvalInfo EvaluateWeights(this TrainingContext trainingContext, Vec weights)
-    {
-      Debug.Assert(weights.Count == trainingContext.WeightCount);
-      var weightArray = weights.ToArray();
-      double error;
-      double[] grad = new double[weightArray.Length];
-      double[] output = new double[trainingContext.NumOutputs];
-      QMEvaluateWeights(trainingContext.Ptr, weightArray, weightArray.Length, output, out error, grad);
-      return new WeightEvalInfo
-        {
-          Output = new DenseVector(output),
-          Error = error,
-          Gradient = new DenseVector(grad)
-        };
-    }
-
-    public static PropagationContext CreatePropagationContext(RNNSpec spec)
-    {
-      var pc = new PropagationContext(QMCreatePropagationContext(Structify(spec.Layers), spec.Layers.Count,
-                                                               spec.NumInputs, spec.Weights.ToArray(), spec.Weights.Count));
-      pc.OriginalSpec = spec;
-      return pc;
-    }
-
-    public static double[] PropagateInput(PropagationContext context, double[] input, int numOutputs)
-    {
-      Debug.Assert(input.Length == context.OriginalSpec.NumInputs);
-      var outputs = new double[numOutputs];
-      QMPropagateInput(context.Ptr, input, outputs);
-      return outputs;
-    }
-
-    static QMLayerSpec[] Structify(IEnumerable<LayerSpec> layers)
-    {
-      return layers.Select(x => new QMLayerSpec(x)).ToArray();
-    }
-
-    public static void FreeQuqeMathDll()
-    {
-      var handle = LoadLibrary("QuqeMath.dll"); // get a handle
-      FreeLibrary(handle); // free for the LoadLibrary() call we just made
-      FreeLibrary(handle); // free for .NET
-    }
-
-    [DllImport("QuqeMath.dll", EntryPoint = "GetWeightCount", CallingConvention = CallingConvention.Cdecl)]
-    static extern int QMGetWeightCount(QMLayerSpec[] layerSpecs, int numLayers, int nInputs);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "CreateTrainingContext", CallingConvention = CallingConvention.Cdecl)]
-    static extern IntPtr QMCreateTrainingContext(QMLayerSpec[] layerSpecs, int numLayers, double[] trainingData, double[] outputData,
-                                                 int nInputs, int nSamples);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "EvaluateWeights", CallingConvention = CallingConvention.Cdecl)]
-    static extern void QMEvaluateWeights(IntPtr trainingContext, double[] weights, int nWeights, double[] output, out double error, double[] gradient);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "DestroyTrainingContext", CallingConvention = CallingConvention.Cdecl)]
-    static extern void QMDestroyTrainingContext(IntPtr context);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "CreatePropagationContext", CallingConvention = CallingConvention.Cdecl)]
-    static extern IntPtr QMCreatePropagationContext(QMLayerSpec[] layerSpecs, int numLayers, int nInputs, double[] weights, int nWeights);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "PropagateInput", CallingConvention = CallingConvention.Cdecl)]
-    static extern void QMPropagateInput(IntPtr propagationContext, double[] input, double[] output);
-
-    [DllImport("QuqeMath.dll", EntryPoint = "DestroyPropagationContext", CallingConvention = CallingConvention.Cdecl)]
-    static extern void QMDestroyPropagationContext(IntPtr context);
-
-    [DllImport("kernel32", SetLastError = true, CharSet = CharSet.Unicode)]
-    static extern IntPtr LoadLibrary(string lpFileName);
-
-    [DllImport("kernel32.dll", SetLastError = true)]
-    [return: MarshalAs(UnmanagedType.Bool)]
-    static extern bool FreeLibrary(IntPtr hModule);
-  }
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Runtime.InteropServices;
+using System.Threading;
+using MathNet.Numerics.LinearAlgebra.Double;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
+
+namespace Quqe
+{
+  public enum ActivationKernel { Scalar = 0, Avx2 = 1, Avx512 = 2 }
+
+  /// <summary>Scalar type a TrainingContext computes in. Mixed uses float activations and sums the gradient in double</summary>
+  public enum TrainingPrecision { Double = 0, Single = 1, Mixed = 2 }
+
+  /// <summary>Truncated backpropagation through time: every Stride timesteps, the errors of those timesteps are
+  /// backpropagated through the last Window timesteps only. Training memory is then O(Window) rather than
+  /// O(sequence length)</summary>
+  public class TruncatedBptt
+  {
+    public readonly int Window;
+    public readonly int Stride;
+
+    public TruncatedBptt(int window, int stride)
+    {
+      if (stride < 1 || stride > window)
+        throw new ArgumentException("Truncated BPTT needs 1 <= stride <= window");
+      Window = window;
+      Stride = stride;
+    }
+  }
+
+  public enum EvaluationStatusCode { Ok = 0, NonFiniteWeights = 1, NonFiniteActivation = 2, NonFiniteGradient = 3 }
+
+  /// <summary>Whether a weight evaluation stayed finite, and if not, where it first went wrong. Layer is that of the
+  /// first non-finite weight, activation or gradient entry; Timestep is only set for activations</summary>
+  [StructLayout(LayoutKind.Sequential)]
+  public struct EvaluationStatus
+  {
+    public EvaluationStatusCode Code;
+    public int Layer;
+    public int Timestep;
+
+    public bool IsOk { get { return Code == EvaluationStatusCode.Ok; } }
+
+    public override string ToString()
+    {
+      return IsOk ? "Ok" : string.Format("{0} at layer {1}, timestep {2}", Code, Layer, Timestep);
+    }
+  }
+
+  /// <summary>Phases of a TrainingContext's life that its stats time</summary>
+  public enum TrainingPhase { Setup = 0, SetWeights = 1, Forward = 2, Backward = 3, Gradient = 4 }
+
+  [StructLayout(LayoutKind.Sequential)]
+  public struct PhaseStats
+  {
+    /// <summary>Timed sections. A truncated BPTT evaluation enters each phase once per chunk</summary>
+    public long Calls;
+    public long Nanoseconds;
+    /// <summary>2 per multiply-add in the matrix products</summary>
+    public double Flops;
+
+    public TimeSpan Elapsed { get { return TimeSpan.FromTicks(Nanoseconds / 100); } }
+  }
+
+  /// <summary>A TrainingContext's counters since it was made or last reset</summary>
+  [StructLayout(LayoutKind.Sequential)]
+  public class TrainingStats
+  {
+    [MarshalAs(UnmanagedType.ByValArray, SizeConst = 5)]
+    public PhaseStats[] Phases = new PhaseStats[5];
+    /// <summary>Calls that ran a forward pass</summary>
+    public long Evaluations;
+    /// <summary>EvaluateGradient calls that ran only the backward pass, over EvaluateError's forward pass</summary>
+    public long ResumedEvaluations;
+    public long Allocations;
+    public long BytesAllocated;
+
+    public PhaseStats this[TrainingPhase phase] { get { return Phases[(int)phase]; } }
+  }
+
+  public static class RNNInterop
+  {
+    const int ACTIVATION_LOGSIG = 0;
+    const int ACTIVATION_PURELIN = 1;
+
+    struct QMLayerSpec
+    {
+      public QMLayerSpec(LayerSpec spec)
+      {
+        NodeCount = spec.NodeCount;
+        IsRecurrent = spec.IsRecurrent;
+        ActivationType = spec.ActivationType == Quqe.ActivationType.LogisticSigmoid ?
+                           ACTIVATION_LOGSIG : ACTIVATION_PURELIN;
+      }
+
+      int NodeCount;
+      bool IsRecurrent;
+      int ActivationType;
+    };
+
+    public class WeightEvalInfo
+    {
+      public Vec Output;
+      public double Error; // NaN unless Status is Ok
+      public Vec Gradient; // zero unless Status is Ok. null from EvaluateError
+      public EvaluationStatus Status;
+    }
+
+    public class SCGResult
+    {
+      public Vec Weights;
+      public List<double> CostHistory;
+      /// <summary>Not Ok if training stopped early because an evaluation went non-finite</summary>
+      public EvaluationStatus Status;
+      /// <summary>Wall time spent in the SCG loop</summary>
+      public double Seconds;
+    }
+
+    interface IContext
+    {
+      IntPtr Ptr { get; }
+    }
+
+    public class PropagationContext : ContextBase
+    {
+      internal PropagationContext(IntPtr ptr) : base(ptr)
+      {
+      }
+
+      protected override void DestroyContext()
+      {
+        QMDestroyPropagationContext(Ptr);
+      }
+
+      public RNNSpec OriginalSpec { get; set; }
+    }
+
+    public class TrainingContext : ContextBase
+    {
+      public readonly int NumOutputs;
+
+      internal TrainingContext(IntPtr ptr, int numOutputs)
+        : base(ptr) { NumOutputs = numOutputs; }
+
+      protected override void DestroyContext() { QMDestroyTrainingContext(Ptr); }
+
+      public int InputCount { get; set; }
+      public int WeightCount { get; set; }
+    }
+
+    /// <summary>Training data in native memory, which any number of training contexts read in place, each over its
+    /// own run of timesteps. The native data set is refcounted, so contexts made from it keep it alive after this
+    /// handle is disposed. Handles cached for the life of a DataSet are never disposed, hence the finalizer</summary>
+    public class DataSetHandle : ContextBase
+    {
+      public readonly int NumInputs;
+      public readonly int NumSamples;
+
+      internal DataSetHandle(IntPtr ptr, int numInputs, int numSamples)
+        : base(ptr)
+      {
+        NumInputs = numInputs;
+        NumSamples = numSamples;
+      }
+
+      ~DataSetHandle() { Dispose(); }
+
+      protected override void DestroyContext() { QMReleaseDataSet(Ptr); }
+    }
+
+    /// <summary>QuqeMath's pool of native threads that run TrainSCG jobs. Each thread takes jobs from its own queue
+    /// in submission order and steals from the others once that is empty, so submit the longest jobs first.
+    /// Disposing cancels whatever hasn't finished</summary>
+    public class TrainingScheduler : ContextBase
+    {
+      // the native threads call this until the scheduler is destroyed, so it mustn't be collected before then
+      internal readonly QMTrainingJobCallback Callback;
+      internal readonly List<Tuple2<int>> JobSizes = new List<Tuple2<int>>(); // weight count and epochMax, by job
+
+      internal TrainingScheduler(IntPtr ptr, QMTrainingJobCallback callback)
+        : base(ptr)
+      {
+        Callback = callback;
+      }
+
+      protected override void DestroyContext() { QMDestroyTrainingScheduler(Ptr); }
+    }
+
+    public class BatchTrainingContext : ContextBase
+    {
+      public readonly int BatchSize;
+      public readonly int NumOutputs;
+
+      internal BatchTrainingContext(IntPtr ptr, int batchSize, int numOutputs)
+        : base(ptr)
+      {
+        BatchSize = batchSize;
+        NumOutputs = numOutputs;
+      }
+
+      protected override void DestroyContext() { QMDestroyBatchTrainingContext(Ptr); }
+
+      public int WeightCount { get; set; }
+    }
+
+    public class EnsembleContext : ContextBase
+    {
+      public readonly int NumInputs;
+
+      internal EnsembleContext(IntPtr ptr, int numInputs)
+        : base(ptr) { NumInputs = numInputs; }
+
+      protected override void DestroyContext() { QMDestroyEnsembleContext(Ptr); }
+
+      public int NumMembers { get; internal set; }
+    }
+
+    public class OrthoContext : ContextBase
+    {
+      public readonly int BasisDimension;
+      public readonly int MaxBasisCount;
+
+      internal OrthoContext(IntPtr ptr, int basisDimension, int maxBasisCount)
+        : base(ptr) { BasisDimension = basisDimension; MaxBasisCount = maxBasisCount; }
+
+      protected override void DestroyContext() { QMDestroyOrthoContext(Ptr); }
+
+      public int BasisCount { get; internal set; }
+    }
+
+    public class EnsemblePrediction
+    {
+      /// <summary>One row per member, one column per time step</summary>
+      public Mat MemberOutputs;
+      /// <summary>Sign of the members' average at each time step</summary>
+      public Vec Votes;
+    }
+
+    public abstract class ContextBase : IDisposable, IContext
+    {
+      readonly IntPtr _Ptr;
+      public IntPtr Ptr { get { return _Ptr; } }
+
+      protected ContextBase(IntPtr ptr)
+      {
+        _Ptr = ptr;
+      }
+
+      bool IsDiposed;
+
+      public void Dispose()
+      {
+        if (IsDiposed) return;
+        IsDiposed = true;
+        DestroyContext();
+      }
+
+      protected abstract void DestroyContext();
+    }
+
+    public static int GetWeightCount(List<LayerSpec> layers, int numInputs)
+    {
+      return QMGetWeightCount(Structify(layers), layers.Count, numInputs);
+    }
+
+    /// <summary>truncation null backpropagates through the whole sequence</summary>
+    public static TrainingContext CreateTrainingContext(List<LayerSpec> layers, Mat trainingData, Vec outputData,
+                                                        TrainingPrecision precision = TrainingPrecision.Double,
+                                                        TruncatedBptt truncation = null)
+    {
+      var ptr = QMCreateTrainingContext(Structify(layers), layers.Count, trainingData.ToRowWiseArray(), outputData.ToArray(),
+                                        trainingData.RowCount, trainingData.ColumnCount, (int)precision,
+                                        truncation != null ? truncation.Window : 0, truncation != null ? truncation.Stride : 0);
+      if (ptr == IntPtr.Zero)
+        throw new ArgumentException("QuqeMath rejected the truncated BPTT window or stride", "truncation");
+      var tc = new TrainingContext(ptr, outputData.Count);
+      tc.InputCount = trainingData.RowCount;
+      tc.WeightCount = GetWeightCount(layers, trainingData.RowCount);
+      return tc;
+    }
+
+    public static DataSetHandle CreateDataSet(Mat trainingData, Vec outputData)
+    {
+      var ptr = QMCreateDataSet(trainingData.ToRowWiseArray(), outputData.ToArray(), trainingData.RowCount, trainingData.ColumnCount);
+      return new DataSetHandle(ptr, trainingData.RowCount, trainingData.ColumnCount);
+    }
+
+    /// <summary>A context over timesteps [offset, offset + length) of data, without copying them</summary>
+    public static TrainingContext CreateTrainingContext(List<LayerSpec> layers, DataSetHandle data, int offset, int length,
+                                                        TrainingPrecision precision = TrainingPrecision.Double,
+                                                        TruncatedBptt truncation = null)
+    {
+      if (offset < 0 || length < 1 || offset + length > data.NumSamples)
+        throw new ArgumentOutOfRangeException("length", "The window must lie within the data set");
+      var ptr = QMCreateTrainingContextOnDataSet(Structify(layers), layers.Count, data.Ptr, offset, length, (int)precision,
+                                                 truncation != null ? truncation.Window : 0, truncation != null ? truncation.Stride : 0);
+      GC.KeepAlive(data);
+      if (ptr == IntPtr.Zero)
+        throw new ArgumentException("QuqeMath rejected the truncated BPTT window or stride", "truncation");
+      var tc = new TrainingContext(ptr, length);
+      tc.InputCount = data.NumInputs;
+      tc.WeightCount = GetWeightCount(layers, data.NumInputs);
+      return tc;
+    }
+
+    public static WeightEvalInfo EvaluateWeights(this TrainingContext trainingContext, Vec weights)
+    {
+      Debug.Assert(weights.Count == trainingContext.WeightCount);
+      var weightArray = ValuesOf(weights);
+      double error;
+      double[] grad = new double[weightArray.Length];
+      double[] output = new double[trainingContext.NumOutputs];
+      QMEvaluateWeights(trainingContext.Ptr, weightArray, weightArray.Length, output, out error, grad);
+      return new WeightEvalInfo
+        {
+          Output = new DenseVector(output),
+          Error = error,
+          Gradient = new DenseVector(grad),
+          Status = GetEvaluationStatus(trainingContext)
+        };
+    }
+
+    /// <summary>EvaluateWeights without the backward pass, so Gradient is null. EvaluateGradient can finish it</summary>
+    public static WeightEvalInfo EvaluateError(this TrainingContext trainingContext, Vec weights)
+    {
+      Debug.Assert(weights.Count == trainingContext.WeightCount);
+      var weightArray = ValuesOf(weights);
+      double error;
+      double[] output = new double[trainingContext.NumOutputs];
+      QMEvaluateError(trainingContext.Ptr, weightArray, weightArray.Length, output, out error);
+      return new WeightEvalInfo
+        {
+          Output = new DenseVector(output),
+          Error = error,
+          Status = GetEvaluationStatus(trainingContext)
+        };
+    }
+
+    /// <summary>Finishes errorOnly, which must be the EvaluateError call just made on these same weights, by running
+    /// only the backward pass. The weights are not compared. If another evaluation came between, errorOnly failed, or
+    /// the context uses truncated BPTT, the whole evaluation is rerun</summary>
+    public static WeightEvalInfo EvaluateGradient(this TrainingContext trainingContext, Vec weights, WeightEvalInfo errorOnly)
+    {
+      Debug.Assert(weights.Count == trainingContext.WeightCount);
+      var weightArray = ValuesOf(weights);
+      double[] grad = new double[weightArray.Length];
+      QMEvaluateGradient(trainingContext.Ptr, weightArray, weightArray.Length, grad);
+      var status = GetEvaluationStatus(trainingContext);
+      return new WeightEvalInfo
+        {
+          Output = status.IsOk ? errorOnly.Output : new DenseVector(trainingContext.NumOutputs, double.NaN),
+          Error = status.IsOk ? errorOnly.Error : double.NaN,
+          Gradient = new DenseVector(grad),
+          Status = status
+        };
+    }
+
+    /// <summary>One training sequence per window, each windowLength samples long, starting at the given column offsets</summary>
+    public static BatchTrainingContext CreateBatchTrainingContext(List<LayerSpec> layers, Mat trainingData, Vec outputData,
+                                                                  int[] windowOffsets, int windowLength)
+    {
+      var ptr = QMCreateBatchTrainingContext(Structify(layers), layers.Count, trainingData.ToRowWiseArray(), outputData.ToArray(),
+                                             trainingData.RowCount, trainingData.ColumnCount, windowOffsets, windowOffsets.Length, windowLength);
+      var bc = new BatchTrainingContext(ptr, windowOffsets.Length, layers.Last().NodeCount);
+      bc.WeightCount = GetWeightCount(layers, trainingData.RowCount);
+      return bc;
+    }
+
+    /// <summary>Evaluates the same weights against every sequence in the batch</summary>
+    public static List<WeightEvalInfo> EvaluateWeightsBatch(this BatchTrainingContext batchContext, Vec weights)
+    {
+      Debug.Assert(weights.Count == batchContext.WeightCount);
+      var weightArray = ValuesOf(weights);
+      int nb = batchContext.BatchSize;
+      int nw = weightArray.Length;
+      int no = batchContext.NumOutputs;
+      var outputs = new double[nb * no];
+      var errors = new double[nb];
+      var grads = new double[nb * nw];
+      QMEvaluateWeightsBatch(batchContext.Ptr, weightArray, nw, outputs, errors, grads);
+      return Enumerable.Range(0, nb).Select(b => new WeightEvalInfo {
+        Output = new DenseVector(outputs.Skip(b * no).Take(no).ToArray()),
+        Error = errors[b],
+        Gradient = new DenseVector(grads.Skip(b * nw).Take(nw).ToArray())
+      }).ToList();
+    }
+
+    /// <summary>Runs the whole Scaled Conjugate Gradient loop natively</summary>
+    public static SCGResult TrainSCG(this TrainingContext trainingContext, Vec initialWeights, int epochMax, double tau,
+                                     Func<bool> canceled = null)
+    {
+      Debug.Assert(initialWeights.Count == trainingContext.WeightCount);
+      var finalWeights = new double[initialWeights.Count];
+      var costHistory = new double[epochMax + 1];
+      int numCosts;
+      var sw = Stopwatch.StartNew();
+      using (var cancelFlag = new CancellationFlag(canceled))
+        numCosts = QMTrainSCG(trainingContext.Ptr, initialWeights.ToArray(), initialWeights.Count, epochMax, tau,
+                              cancelFlag.Ptr, finalWeights, costHistory);
+      return new SCGResult {
+        Weights = new DenseVector(finalWeights),
+        CostHistory = costHistory.Take(numCosts).ToList(),
+        Status = trainingContext.GetEvaluationStatus(),
+        Seconds = sw.Elapsed.TotalSeconds
+      };
+    }
+
+    /// <summary>numThreads 0 uses every hardware thread. jobCompleted is called with the job number on the native
+    /// thread that ran it, as soon as its result can be read, so it should hand the work off rather than do it</summary>
+    public static TrainingScheduler CreateTrainingScheduler(int numThreads = 0, Action<int> jobCompleted = null)
+    {
+      QMTrainingJobCallback callback = null;
+      if (jobCompleted != null)
+        callback = (job, state) => jobCompleted(job);
+      return new TrainingScheduler(QMCreateTrainingScheduler(numThreads, callback, IntPtr.Zero), callback);
+    }
+
+    /// <summary>Queues a TrainSCG run over timesteps [offset, offset + length) of data and returns its job number.
+    /// Job numbers count up from 0 in submission order</summary>
+    public static int SubmitTrainingJob(this TrainingScheduler scheduler, List<LayerSpec> layers, DataSetHandle data,
+                                        int offset, int length, Vec initialWeights, int epochMax, double tau,
+                                        TrainingPrecision precision = TrainingPrecision.Double,
+                                        TruncatedBptt truncation = null)
+    {
+      Debug.Assert(initialWeights.Count == GetWeightCount(layers, data.NumInputs));
+      lock (scheduler.JobSizes)
+      {
+        int job = QMSubmitTrainingJob(scheduler.Ptr, Structify(layers), layers.Count, data.Ptr, offset, length, (int)precision,
+                                      truncation != null ? truncation.Window : 0, truncation != null ? truncation.Stride : 0,
+                                      initialWeights.ToArray(), initialWeights.Count, epochMax, tau);
+        GC.KeepAlive(data);
+        if (job < 0)
+          throw new ArgumentException("QuqeMath rejected the data window, the truncated BPTT window or stride, or the weight count");
+        Debug.Assert(job == scheduler.JobSizes.Count);
+        scheduler.JobSizes.Add(Tuple2.Create(initialWeights.Count, epochMax));
+        return job;
+      }
+    }
+
+    /// <summary>Stops the job at its next epoch, or before it starts</summary>
+    public static void CancelTrainingJob(this TrainingScheduler scheduler, int job)
+    {
+      QMCancelTrainingJob(scheduler.Ptr, job);
+    }
+
+    public static void CancelAllTrainingJobs(this TrainingScheduler scheduler)
+    {
+      QMCancelTrainingJob(scheduler.Ptr, -1);
+    }
+
+    /// <summary>Blocks until every job submitted so far has finished and had its jobCompleted call</summary>
+    public static void WaitForTrainingJobs(this TrainingScheduler scheduler)
+    {
+      QMWaitForTrainingJobs(scheduler.Ptr);
+    }
+
+    /// <summary>null if the job hasn't finished. CostHistory is empty if it was canceled before it started</summary>
+    public static SCGResult GetTrainingJobResult(this TrainingScheduler scheduler, int job)
+    {
+      Tuple2<int> size;
+      lock (scheduler.JobSizes)
+      {
+        if (job < 0 || job >= scheduler.JobSizes.Count)
+          throw new ArgumentOutOfRangeException("job", "No such training job");
+        size = scheduler.JobSizes[job];
+      }
+      var finalWeights = new double[size.Item1];
+      var costHistory = new double[size.Item2 + 1];
+      EvaluationStatus status;
+      double seconds;
+      int numCosts = QMGetTrainingJobResult(scheduler.Ptr, job, finalWeights, costHistory, out status, out seconds);
+      if (numCosts == -2)
+        throw new ArgumentOutOfRangeException("job", "No such training job");
+      if (numCosts < 0)
+        return null;
+      return new SCGResult {
+        Weights = new DenseVector(finalWeights),
+        CostHistory = costHistory.Take(numCosts).ToList(),
+        Status = status,
+        Seconds = seconds
+      };
+    }
+
+    /// <summary>A native int that is set to 1 once the managed predicate returns true. Native loops poll it.</summary>
+    internal class CancellationFlag : IDisposable
+    {
+      public readonly IntPtr Ptr;
+      readonly Timer Poller;
+
+      public CancellationFlag(Func<bool> canceled)
+      {
+        Ptr = Marshal.AllocHGlobal(sizeof(int));
+        Marshal.WriteInt32(Ptr, 0);
+        if (canceled != null)
+          Poller = new Timer(_ => {
+            if (canceled())
+              Marshal.WriteInt32(Ptr, 1);
+          }, null, 0, 100);
+      }
+
+      public void Dispose()
+      {
+        if (Poller != null)
+        {
+          using (var stopped = new ManualResetEvent(false))
+          {
+            Poller.Dispose(stopped);
+            stopped.WaitOne();
+          }
+        }
+        Marshal.FreeHGlobal(Ptr);
+      }
+    }
+
+    /// <summary>Number of native buffers allocated by the most recent EvaluateWeights call</summary>
+    public static int GetEvaluationAllocationCount(this TrainingContext trainingContext)
+    {
+      return QMGetEvaluationAllocationCount(trainingContext.Ptr);
+    }
+
+    /// <summary>Status of the context's last evaluation, including the one that stopped TrainSCG</summary>
+    public static EvaluationStatus GetEvaluationStatus(this TrainingContext trainingContext)
+    {
+      EvaluationStatus status;
+      QMGetEvaluationStatus(trainingContext.Ptr, out status);
+      return status;
+    }
+
+    /// <summary>null if QuqeMath was built with QUQEMATH_STATS=0</summary>
+    public static TrainingStats GetStats(this TrainingContext trainingContext)
+    {
+      var stats = new TrainingStats();
+      return QMGetContextStats(trainingContext.Ptr, stats) != 0 ? stats : null;
+    }
+
+    public static void ResetStats(this TrainingContext trainingContext)
+    {
+      QMResetContextStats(trainingContext.Ptr);
+    }
+
+    /// <summary>The widest activation kernel the CPU supports, which is what training uses</summary>
+    public static ActivationKernel GetActivationKernel()
+    {
+      return (ActivationKernel)QMGetActivationKernel();
+    }
+
+    public static double[] ApplyLogisticSigmoid(double[] x, ActivationKernel kernel)
+    {
+      var y = new double[x.Length];
+      if (QMApplyLogisticSigmoid(x, y, x.Length, (int)kernel) != (int)kernel)
+        throw new NotSupportedException("Activation kernel " + kernel + " is not supported on this CPU");
+      return y;
+    }
+
+    /// <summary>exp with the given kernel. The RBF kernel matrix uses the best one</summary>
+    public static double[] ApplyExp(double[] x, ActivationKernel kernel)
+    {
+      var y = new double[x.Length];
+      if (QMApplyExp(x, y, x.Length, (int)kernel) != (int)kernel)
+        throw new NotSupportedException("Activation kernel " + kernel + " is not supported on this CPU");
+      return y;
+    }
+
+    /// <summary>Propagates the nSteps columns of rowWiseInputs starting at startColumn, in order, as repeated
+    /// PropagateInput calls would. rowWiseInputs is a row-major matrix with ldInputs columns.
+    /// Returns nSteps consecutive groups of outputs</summary>
+    public static double[] PropagateSequence(PropagationContext context, double[] rowWiseInputs, int ldInputs, int startColumn, int nSteps)
+    {
+      var numInputs = context.OriginalSpec.NumInputs;
+      var numOutputs = context.OriginalSpec.Layers.Last().NodeCount;
+      Debug.Assert(startColumn >= 0 && startColumn + nSteps <= ldInputs);
+      Debug.Assert(rowWiseInputs.Length == numInputs * ldInputs);
+      var outputs = new double[nSteps * numOutputs];
+      if (nSteps > 0)
+        QMPropagateSequence(context.Ptr, ref rowWiseInputs[startColumn], numInputs, nSteps, outputs, ldInputs);
+      return outputs;
+    }
+
+    /// <summary>Returns a copy of the context's recurrent state, which RestoreState can later put back</summary>
+    public static double[] SaveState(PropagationContext context)
+    {
+      var state = new double[QMGetStateSize(context.Ptr)];
+      QMSaveState(context.Ptr, state);
+      return state;
+    }
+
+    public static void RestoreState(PropagationContext context, double[] state)
+    {
+      if (state.Length != QMGetStateSize(context.Ptr))
+        throw new ArgumentException("State is from a different network");
+      QMRestoreState(context.Ptr, state);
+    }
+
+    public static void ResetState(PropagationContext context)
+    {
+      QMResetState(context.Ptr);
+    }
+
+    /// <summary>Creates an ensemble whose members read row ranges of one shared input matrix with numInputs rows.
+    /// maxMembers bounds the number of Add*Member calls</summary>
+    public static EnsembleContext CreateEnsembleContext(int numInputs, int maxMembers)
+    {
+      return new EnsembleContext(QMCreateEnsembleContext(numInputs, maxMembers), numInputs);
+    }
+
+    public static int AddRnnMember(EnsembleContext context, int inputOffset, RNNSpec spec)
+    {
+      var index = QMAddRnnMember(context.Ptr, inputOffset, Structify(spec.Layers), spec.Layers.Count, spec.NumInputs,
+                                 spec.Weights.ToArray(), spec.Weights.Count);
+      context.NumMembers++;
+      return index;
+    }
+
+    public static int AddRbfMember(EnsembleContext context, int inputOffset, RBFNet net)
+    {
+      var numInputs = net.Bases.Any() ? net.Bases.First().Center.Count : 0;
+      var centers = net.Bases.SelectMany(b => b.Center).ToArray();
+      var weights = net.Bases.Select(b => b.Weight).ToArray();
+      var index = QMAddRbfMember(context.Ptr, inputOffset, numInputs, centers, weights, net.Bases.Count,
+                                 net.OutputBias, net.Spread, net.IsDegenerate ? 1 : 0);
+      context.NumMembers++;
+      return index;
+    }
+
+    /// <summary>Evaluates every member on the nSteps columns of rowWiseInputs starting at startColumn.
+    /// rowWiseInputs is a row-major matrix with ldInputs columns. RNN members carry their state into the next call</summary>
+    public static EnsemblePrediction PredictEnsemble(EnsembleContext context, double[] rowWiseInputs, int ldInputs, int startColumn, int nSteps, int numThreads)
+    {
+      Debug.Assert(startColumn >= 0 && startColumn + nSteps <= ldInputs);
+      Debug.Assert(rowWiseInputs.Length == context.NumInputs * ldInputs);
+      var memberOutputs = new double[context.NumMembers * nSteps];
+      var votes = new double[nSteps];
+      if (nSteps > 0)
+        QMEnsemblePredict(context.Ptr, ref rowWiseInputs[startColumn], nSteps, ldInputs, memberOutputs, votes, numThreads);
+      return new EnsemblePrediction {
+        MemberOutputs = new DenseMatrix(nSteps, context.NumMembers, memberOutputs).Transpose(),
+        Votes = new DenseVector(votes)
+      };
+    }
+
+    public static void ResetEnsembleState(EnsembleContext context)
+    {
+      QMResetEnsembleState(context.Ptr);
+    }
+
+    public static OrthoContext CreateOrthoContext(int basisDimension, int maxBasisCount)
+    {
+      return new OrthoContext(QMCreateOrthoContext(basisDimension, maxBasisCount), basisDimension, maxBasisCount);
+    }
+
+    /// <summary>basis must be normalized and orthogonal to the bases already appended</summary>
+    public static void AppendBasis(OrthoContext context, Vec basis)
+    {
+      Debug.Assert(basis.Count == context.BasisDimension && context.BasisCount < context.MaxBasisCount);
+      context.BasisCount = QMAppendBasis(context.Ptr, basis.ToArray());
+    }
+
+    /// <summary>The normalized component of each candidate orthogonal to the context's bases</summary>
+    public static List<Vec> OrthogonalizeMany(OrthoContext context, IList<Vec> candidates)
+    {
+      var dim = context.BasisDimension;
+      var data = candidates.SelectMany(v => v).ToArray();
+      Debug.Assert(data.Length == candidates.Count * dim);
+      if (candidates.Any())
+        QMOrthogonalizeMany(context.Ptr, data, candidates.Count);
+      return Lists.Repeat(candidates.Count, i => (Vec)new DenseVector(data.Skip(i * dim).Take(dim).ToArray()));
+    }
+
+    public static PropagationContext CreatePropagationContext(RNNSpec spec)
+    {
+      var pc = new PropagationContext(QMCreatePropagationContext(Structify(spec.Layers), spec.Layers.Count,
+                                                               spec.NumInputs, spec.Weights.ToArray(), spec.Weights.Count));
+      pc.OriginalSpec = spec;
+      return pc;
+    }
+
+    public static double[] PropagateInput(PropagationContext context, double[] input, int numOutputs)
+    {
+      Debug.Assert(input.Length == context.OriginalSpec.NumInputs);
+      var outputs = new double[numOutputs];
+      QMPropagateInput(context.Ptr, input, outputs);
+      return outputs;
+    }
+
+    static QMLayerSpec[] Structify(IEnumerable<LayerSpec> layers)
+    {
+      return layers.Select(x => new QMLayerSpec(x)).ToArray();
+    }
+
+    /// <summary>A dense vector's own storage, so the marshaler pins it for the call instead of it being copied.
+    /// Native code only reads weights passed this way</summary>
+    static double[] ValuesOf(Vec v)
+    {
+      var dense = v as DenseVector;
+      return dense != null ? dense.Values : v.ToArray();
+    }
+
+    public static void FreeQuqeMathDll()
+    {
+      var handle = LoadLibrary("QuqeMath.dll"); // get a handle
+      FreeLibrary(handle); // free for the LoadLibrary() call we just made
+      FreeLibrary(handle); // free for .NET
+    }
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetWeightCount", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetWeightCount(QMLayerSpec[] layerSpecs, int numLayers, int nInputs);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateTrainingContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateTrainingContext(QMLayerSpec[] layerSpecs, int numLayers, double[] trainingData, double[] outputData,
+                                                 int nInputs, int nSamples, int precision, int bpttWindow, int bpttStride);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateDataSet", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateDataSet(double[] trainingData, double[] outputData, int nInputs, int nSamples);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ReleaseDataSet", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMReleaseDataSet(IntPtr data);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateTrainingContextOnDataSet", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateTrainingContextOnDataSet(QMLayerSpec[] layerSpecs, int numLayers, IntPtr data, int offset, int length,
+                                                          int precision, int bpttWindow, int bpttStride);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "EvaluateWeights", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMEvaluateWeights(IntPtr trainingContext, double[] weights, int nWeights, double[] output, out double error, double[] gradient);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "EvaluateError", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMEvaluateError(IntPtr trainingContext, double[] weights, int nWeights, double[] output, out double error);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "EvaluateGradient", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMEvaluateGradient(IntPtr trainingContext, double[] weights, int nWeights, double[] gradient);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetEvaluationStatus", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetEvaluationStatus(IntPtr trainingContext, out EvaluationStatus status);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyTrainingContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyTrainingContext(IntPtr context);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateBatchTrainingContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateBatchTrainingContext(QMLayerSpec[] layerSpecs, int numLayers, double[] trainingData, double[] outputData,
+                                                      int nInputs, int nSamples, int[] windowOffsets, int nWindows, int windowLength);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "EvaluateWeightsBatch", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMEvaluateWeightsBatch(IntPtr batchContext, double[] weights, int nWeights, double[] outputs, double[] errors, double[] gradients);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyBatchTrainingContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyBatchTrainingContext(IntPtr context);
+
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    internal delegate void QMTrainingJobCallback(int job, IntPtr state);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateTrainingScheduler", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateTrainingScheduler(int nThreads, QMTrainingJobCallback callback, IntPtr callbackState);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "SubmitTrainingJob", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMSubmitTrainingJob(IntPtr scheduler, QMLayerSpec[] layerSpecs, int numLayers, IntPtr data, int offset, int length,
+                                          int precision, int bpttWindow, int bpttStride, double[] initialWeights, int nWeights,
+                                          int epochMax, double tau);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CancelTrainingJob", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMCancelTrainingJob(IntPtr scheduler, int job);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "WaitForTrainingJobs", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMWaitForTrainingJobs(IntPtr scheduler);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetTrainingJobResult", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetTrainingJobResult(IntPtr scheduler, int job, double[] finalWeights, double[] costHistory,
+                                             out EvaluationStatus status, out double seconds);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyTrainingScheduler", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyTrainingScheduler(IntPtr scheduler);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "TrainSCG", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMTrainSCG(IntPtr trainingContext, double[] initialWeights, int nWeights, int epochMax, double tau,
+                                 IntPtr cancelFlag, double[] finalWeights, double[] costHistory);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetEvaluationAllocationCount", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetEvaluationAllocationCount(IntPtr trainingContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetContextStats", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetContextStats(IntPtr trainingContext, [Out] TrainingStats stats);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ResetContextStats", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMResetContextStats(IntPtr trainingContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetActivationKernel", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetActivationKernel();
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ApplyLogisticSigmoid", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMApplyLogisticSigmoid(double[] x, double[] y, int n, int kernel);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ApplyExp", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMApplyExp(double[] x, double[] y, int n, int kernel);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreatePropagationContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreatePropagationContext(QMLayerSpec[] layerSpecs, int numLayers, int nInputs, double[] weights, int nWeights);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "PropagateInput", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMPropagateInput(IntPtr propagationContext, double[] input, double[] output);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "PropagateSequence", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMPropagateSequence(IntPtr propagationContext, ref double inputs, int nInputs, int nSteps, double[] outputs, int ldInputs);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "GetStateSize", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMGetStateSize(IntPtr propagationContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "SaveState", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMSaveState(IntPtr propagationContext, double[] state);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "RestoreState", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMRestoreState(IntPtr propagationContext, double[] state);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ResetState", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMResetState(IntPtr propagationContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateEnsembleContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateEnsembleContext(int nInputs, int maxMembers);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "AddRnnMember", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMAddRnnMember(IntPtr ensembleContext, int inputOffset, QMLayerSpec[] layerSpecs, int nLayers, int nInputs,
+      double[] weights, int nWeights);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "AddRbfMember", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMAddRbfMember(IntPtr ensembleContext, int inputOffset, int nInputs, double[] centers, double[] weights,
+      int nCenters, double outputBias, double spread, int isDegenerate);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "EnsemblePredict", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMEnsemblePredict(IntPtr ensembleContext, ref double inputs, int nSteps, int ldInputs,
+      double[] memberOutputs, double[] votes, int nThreads);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "ResetEnsembleState", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMResetEnsembleState(IntPtr ensembleContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyEnsembleContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyEnsembleContext(IntPtr ensembleContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "CreateOrthoContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern IntPtr QMCreateOrthoContext(int basisDimension, int maxBasisCount);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "AppendBasis", CallingConvention = CallingConvention.Cdecl)]
+    static extern int QMAppendBasis(IntPtr orthoContext, double[] basis);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "OrthogonalizeMany", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMOrthogonalizeMany(IntPtr orthoContext, double[] candidates, int count);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyOrthoContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyOrthoContext(IntPtr orthoContext);
+
+    [DllImport("QuqeMath.dll", EntryPoint = "DestroyPropagationContext", CallingConvention = CallingConvention.Cdecl)]
+    static extern void QMDestroyPropagationContext(IntPtr context);
+
+    [DllImport("kernel32", SetLastError = true, CharSet = CharSet.Unicode)]
+    static extern IntPtr LoadLibrary(string lpFileName);
+
+    [DllImport("kernel32.dll", SetLastError = true)]
+    [return: MarshalAs(UnmanagedType.Bool)]
+    static extern bool FreeLibrary(IntPtr hModule);
+  }
 }
\ No newline at end of file
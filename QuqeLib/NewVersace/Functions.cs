@@ -1,130 +1,137 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Diagnostics;
-using System.Linq;
-using Quqe.NewVersace;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
-using Quqe.Rabbit;
-
-namespace Quqe
-{
-  public static partial class Functions
-  {
-    public static Run Evolve(ProtoRun protoRun, IGenTrainer trainer, DataSet trainingSet, DataSet validationSet,
-      string symbol = null, DateTime startDate = default(DateTime), DateTime endDate = default(DateTime), double validationPct = 0, 
-      Action<int, int, int> onGenerationProgress = null,
-      Action<Generation> onGenerationComplete = null)
-    {
-      var run = new Run(protoRun, protoRun.ProtoChromosome, null, startDate, endDate, validationPct);
-      var gen = Initialization.MakeInitialGeneration(trainingSet, run, trainer);
-
-      while (true)
-      {
-        var evaluated = Evaluate(gen, validationSet);
-        onGenerationComplete(gen);
-        if (gen.Order == protoRun.NumGenerations - 1)
-          return run;
-
-        gen = Train(trainer, trainingSet, run, gen.Order + 1, onGenerationProgress,
-                    Mutate(run,
-                           Combine(protoRun.MixturesPerGeneration,
-                                   Select(protoRun.SelectionSize,
-                                          evaluated))));
-      }
-    }
-
-    static Generation Train(IGenTrainer trainer, DataSet seed, Run run, int generationNum, Action<int, int, int> onGenerationProgress, MixtureInfo[] pop)
-    {
-      var gen = new Generation(run, generationNum);
-      trainer.Train(seed, gen, pop.Select(mi => new MixtureInfo(new Mixture(gen, mi.Parents).Id, mi.Chromosomes)).ToArray(),
-                    progress => onGenerationProgress.Fire(generationNum, progress.Completed, progress.Total));
-      return gen;
-    }
-
-    static MixtureEval[] Evaluate(Generation gen, DataSet data)
-    {
-      Console.Write("Evaluating generation " + gen.Order + " ...");
-      var evaluatedMixtures = gen.Mixtures.Select(m => EvaluateMixture(m, data)).ToArray();
-      new GenEval(gen, evaluatedMixtures.Max(x => x.Fitness));
-      Console.WriteLine("done");
-      return evaluatedMixtures;
-    }
-
-    static MixtureEval EvaluateMixture(Mixture m, DataSet data)
-    {
-      using (var mixturePredictor = new MixturePredictor(m, data))
-        return new MixtureEval(m, ComputeFitness(mixturePredictor, data));
-    }
-
-    public static double ComputeFitness(IPredictorWithInputs predictor, DataSet data, int preloadCount = 0)
-    {
-      var predictions = Lists.Repeat(data.Input.ColumnCount, t => predictor.Predict(t));
-      var accuracy = predictions.Zip(data.Output, (predicted, actual) => Math.Sign(predicted) == Math.Sign(actual) ? 1 : 0).Skip(preloadCount).Average();
-      return accuracy;
-    }
-
-    static MixtureEval[] Select(int selectionSize, IEnumerable<MixtureEval> ms)
-    {
-      return ms.OrderByDescending(x => x.Fitness).Take(selectionSize).ToArray();
-    }
-
-    internal static MixtureInfo[] Combine(int outputSize, IList<MixtureEval> ms)
-    {
-      return Lists.Repeat((int)Math.Ceiling(outputSize / 2.0), _ => CombineTwoMixtures(ms)).SelectMany(x => x).Take(outputSize).ToArray();
-    }
-
-    internal static Tuple2<MixtureInfo> CombineTwoMixtures(IList<MixtureEval> ms)
-    {
-      var parents = SelectTwoAccordingToQuality(ms, x => x.Fitness);
-
-      Func<IEnumerable<Chromosome>, MixtureInfo> chromosomesToMixture =
-        chromosomes => new MixtureInfo(parents.Select(p => p.Mixture), chromosomes);
-
-      return CrossOver(parents.Item1.Mixture.Chromosomes, parents.Item2.Mixture.Chromosomes, CrossOverChromosomes, chromosomesToMixture);
-    }
-
-    internal static Tuple2<Chromosome> CrossOverChromosomes(Chromosome a, Chromosome b)
-    {
-      Debug.Assert(a.NetworkType == b.NetworkType);
-      Debug.Assert(a.OrderInMixture == b.OrderInMixture);
-
-      Func<Gene, Gene, Tuple2<Gene>> crossGenes = (x, y) => {
-        Debug.Assert(x.Name == y.Name);
-        return QuqeUtil.WithProb(0.5) ? Tuple2.Create(x, y) : Tuple2.Create(y, x);
-      };
-
-      return CrossOver(a.Genes, b.Genes, crossGenes, genes => new Chromosome(a.NetworkType, genes, a.OrderInMixture));
-    }
-
-    static MixtureInfo[] Mutate(Run run, IEnumerable<MixtureInfo> ms)
-    {
-      return ms.Select(mi => new MixtureInfo(mi.Parents, MutateChromosomes(mi.Chromosomes, run))).ToArray();
-    }
-
-    static Chromosome[] MutateChromosomes(IEnumerable<Chromosome> chromosomes, Run run)
-    {
-      return chromosomes.Select(x => MutateChromosome(x, run)).ToArray();
-    }
-
-    internal static Chromosome MutateChromosome(Chromosome c, Run run)
-    {
-      return new Chromosome(c.NetworkType, c.Genes.Select(x => MutateGene(x, run)), c.OrderInMixture);
-    }
-
-    static Gene MutateGene(Gene g, Run run)
-    {
-      return new Gene(g.Name, QuqeUtil.WithProb(run.ProtoRun.MutationRate) ? RandomGeneValue(g.GetProto(run)) : g.Value);
-    }
-
-    public static double RandomGeneValue(ProtoGene gd)
-    {
-      return Quantize(RandomDouble(gd.MinValue, gd.MaxValue), gd.MinValue, gd.Granularity);
-    }
-  }
-
-  public interface IPredictor : IDisposable
-  {
-    double Predict(Vec input);
-  }
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Quqe.NewVersace;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
+using Quqe.Rabbit;
+
+namespace Quqe
+{
+  public static partial class Functions
+  {
+    public static Run Evolve(ProtoRun protoRun, IGenTrainer trainer, DataSet trainingSet, DataSet validationSet,
+      string symbol = null, DateTime startDate = default(DateTime), DateTime endDate = default(DateTime), double validationPct = 0, 
+      Action<int, int, int> onGenerationProgress = null,
+      Action<Generation> onGenerationComplete = null)
+    {
+      var run = new Run(protoRun, protoRun.ProtoChromosome, null, startDate, endDate, validationPct);
+      var gen = Initialization.MakeInitialGeneration(trainingSet, run, trainer);
+
+      while (true)
+      {
+        var evaluated = Evaluate(gen, validationSet);
+        onGenerationComplete(gen);
+        if (gen.Order == protoRun.NumGenerations - 1)
+          return run;
+
+        gen = Train(trainer, trainingSet, run, gen.Order + 1, onGenerationProgress,
+                    Mutate(run,
+                           Combine(protoRun.MixturesPerGeneration,
+                                   Select(protoRun.SelectionSize,
+                                          evaluated))));
+      }
+    }
+
+    static Generation Train(IGenTrainer trainer, DataSet seed, Run run, int generationNum, Action<int, int, int> onGenerationProgress, MixtureInfo[] pop)
+    {
+      var gen = new Generation(run, generationNum);
+      trainer.Train(seed, gen, pop.Select(mi => new MixtureInfo(new Mixture(gen, mi.Parents).Id, mi.Chromosomes)).ToArray(),
+                    progress => onGenerationProgress.Fire(generationNum, progress.Completed, progress.Total));
+      return gen;
+    }
+
+    static MixtureEval[] Evaluate(Generation gen, DataSet data)
+    {
+      Console.Write("Evaluating generation " + gen.Order + " ...");
+      var evaluatedMixtures = gen.Mixtures.Select(m => EvaluateMixture(m, data)).ToArray();
+      new GenEval(gen, evaluatedMixtures.Max(x => x.Fitness));
+      Console.WriteLine("done");
+      return evaluatedMixtures;
+    }
+
+    static MixtureEval EvaluateMixture(Mixture m, DataSet data)
+    {
+      using (var mixturePredictor = new MixturePredictor(m, data))
+        return new MixtureEval(m, ComputeFitness(mixturePredictor, data));
+    }
+
+    public static double ComputeFitness(IPredictorWithInputs predictor, DataSet data, int preloadCount = 0)
+    {
+      var predictions = Lists.Repeat(data.Input.ColumnCount, t => predictor.Predict(t));
+      var accuracy = predictions.Zip(data.Output, (predicted, actual) => Math.Sign(predicted) == Math.Sign(actual) ? 1 : 0).Skip(preloadCount).Average();
+      return accuracy;
+    }
+
+    static MixtureEval[] Select(int selectionSize, IEnumerable<MixtureEval> ms)
+    {
+      return ms.OrderByDescending(x => x.Fitness).Take(selectionSize).ToArray();
+    }
+
+    internal static MixtureInfo[] Combine(int outputSize, IList<MixtureEval> ms)
+    {
+      return Lists.Repeat((int)Math.Ceiling(outputSize / 2.0), _ => CombineTwoMixtures(ms)).SelectMany(x => x).Take(outputSize).ToArray();
+    }
+
+    internal static Tuple2<MixtureInfo> CombineTwoMixtures(IList<MixtureEval> ms)
+    {
+      var parents = SelectTwoAccordingToQuality(ms, x => x.Fitness);
+
+      Func<IEnumerable<Chromosome>, MixtureInfo> chromosomesToMixture =
+        chromosomes => new MixtureInfo(parents.Select(p => p.Mixture), chromosomes);
+
+      return CrossOver(parents.Item1.Mixture.Chromosomes, parents.Item2.Mixture.Chromosomes, CrossOverChromosomes, chromosomesToMixture);
+    }
+
+    internal static Tuple2<Chromosome> CrossOverChromosomes(Chromosome a, Chromosome b)
+    {
+      Debug.Assert(a.NetworkType == b.NetworkType);
+      Debug.Assert(a.OrderInMixture == b.OrderInMixture);
+
+      Func<Gene, Gene, Tuple2<Gene>> crossGenes = (x, y) => {
+        Debug.Assert(x.Name == y.Name);
+        return QuqeUtil.WithProb(0.5) ? Tuple2.Create(x, y) : Tuple2.Create(y, x);
+      };
+
+      return CrossOver(a.Genes, b.Genes, crossGenes, genes => new Chromosome(a.NetworkType, genes, a.OrderInMixture));
+    }
+
+    static MixtureInfo[] Mutate(Run run, IEnumerable<MixtureInfo> ms)
+    {
+      return ms.Select(mi => new MixtureInfo(mi.Parents, MutateChromosomes(mi.Chromosomes, run))).ToArray();
+    }
+
+    static Chromosome[] MutateChromosomes(IEnumerable<Chromosome> chromosomes, Run run)
+    {
+      return chromosomes.Select(x => MutateChromosome(x, run)).ToArray();
+    }
+
+    internal static Chromosome MutateChromosome(Chromosome c, Run run)
+    {
+      return new Chromosome(c.NetworkType, c.Genes.Select(x => MutateGene(x, run)), c.OrderInMixture);
+    }
+
+    static Gene MutateGene(Gene g, Run run)
+    {
+      return new Gene(g.Name, QuqeUtil.WithProb(run.ProtoRun.MutationRate) ? RandomGeneValue(g.GetProto(run)) : g.Value);
+    }
+
+    public static double RandomGeneValue(ProtoGene gd)
+    {
+      return Quantize(RandomDouble(gd.MinValue, gd.MaxValue), gd.MinValue, gd.Granularity);
+    }
+  }
+
+  public interface IPredictor : IDisposable
+  {
+    double Predict(Vec input);
+  }
+
+  /// <summary>A predictor that can run a whole input matrix (one column per time step) in one call.
+  /// Equivalent to calling Predict on each column in order</summary>
+  public interface ISequencePredictor : IPredictor
+  {
+    Vec PredictSequence(Mat inputs);
+  }
 }
\ No newline at end of file
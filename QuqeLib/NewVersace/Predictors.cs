@@ -1,99 +1,102 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Linq;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
-
-namespace Quqe.NewVersace
-{
-  public interface IPredictorWithInputs : IDisposable
-  {
-    double Predict(int t);
-  }
-
-  class ExpertPredictor : IPredictorWithInputs
-  {
-    readonly Mat TailoredInputs;
-    readonly IPredictor Predictor;
-
-    public ExpertPredictor(Expert expert, Mat inputs, int databaseAInputLength)
-    {
-      TailoredInputs = DataTailoring.TailorInputs(inputs, databaseAInputLength, expert.Chromosome);
-      Predictor = MakePredictor(expert);
-    }
-
-    static IPredictor MakePredictor(Expert expert)
-    {
-      if (expert is RnnTrainRec)
-      {
-        var trainRec = (RnnTrainRec)expert;
-        return new RNN(trainRec.RnnSpec.ToRnnSpec());
-      }
-      else if (expert is RbfTrainRec)
-      {
-        var trainRec = (RbfTrainRec)expert;
-        return new RBFNet(trainRec.Bases.Select(b => b.ToRadialBasis()), trainRec.OutputBias, trainRec.Spread, trainRec.IsDegenerate);
-      }
-      else
-        throw new Exception("Unexpected expert type");
-    }
-
-    public double Predict(int t)
-    {
-      return Predictor.Predict(TailoredInputs.Column(t));
-    }
-
-    public void Dispose()
-    {
-      Predictor.Dispose();
-    }
-  }
-
-  class MixturePredictor : IPredictorWithInputs
-  {
-    List<ExpertPredictor> ExpertPredictors;
-
-    public MixturePredictor(IEnumerable<ExpertPredictor> expertPredictors)
-    {
-      ExpertPredictors = expertPredictors.ToList();
-    }
-
-    public MixturePredictor(Mixture mixture, DataSet data)
-    {
-      ExpertPredictors = mixture.Experts.Select(x => new ExpertPredictor(x, data.Input, data.DatabaseAInputLength)).ToList();
-    }
-
-    public double Predict(int t)
-    {
-      return Math.Sign(ExpertPredictors.Select(ep => ep.Predict(t)).Average());
-    }
-
-    public void Dispose()
-    {
-      foreach (var ep in ExpertPredictors)
-        ep.Dispose();
-    }
-  }
-
-  class PredictorWithInputs : IPredictorWithInputs
-  {
-    readonly Mat Inputs;
-    readonly IPredictor Predictor;
-
-    public PredictorWithInputs(IPredictor predictor, Mat inputs)
-    {
-      Predictor = predictor;
-      Inputs = inputs;
-    }
-
-    public double Predict(int t)
-    {
-      return Predictor.Predict(Inputs.Column(t));
-    }
-
-    public void Dispose()
-    {
-      Predictor.Dispose();
-    }
-  }
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
+
+namespace Quqe.NewVersace
+{
+  public interface IPredictorWithInputs : IDisposable
+  {
+    double Predict(int t);
+  }
+
+  /// <summary>Evaluates all of a mixture's experts natively in one ensemble. Each expert reads its own
+  /// tailored inputs, which are stacked into one input matrix</summary>
+  class MixturePredictor : IPredictorWithInputs
+  {
+    readonly RNNInterop.EnsembleContext Ensemble;
+    readonly double[] RowWiseInputs;
+    readonly int NumColumns;
+    Vec Votes;
+
+    public MixturePredictor(Mixture mixture, DataSet data)
+    {
+      var experts = mixture.Experts.ToList();
+      var tailoredInputs = experts.Select(x => DataTailoring.TailorInputs(data.Input, data.DatabaseAInputLength, x.Chromosome)).ToList();
+      var numInputs = tailoredInputs.Sum(x => x.RowCount);
+      NumColumns = data.Input.ColumnCount;
+      RowWiseInputs = new double[numInputs * NumColumns];
+      Ensemble = RNNInterop.CreateEnsembleContext(numInputs, experts.Count);
+
+      int inputOffset = 0;
+      for (int i = 0; i < experts.Count; i++)
+      {
+        var inputs = tailoredInputs[i];
+        Array.Copy(inputs.ToRowWiseArray(), 0, RowWiseInputs, inputOffset * NumColumns, inputs.RowCount * NumColumns);
+        AddMember(experts[i], inputOffset);
+        inputOffset += inputs.RowCount;
+      }
+    }
+
+    void AddMember(Expert expert, int inputOffset)
+    {
+      if (expert is RnnTrainRec)
+      {
+        var trainRec = (RnnTrainRec)expert;
+        RNNInterop.AddRnnMember(Ensemble, inputOffset, trainRec.RnnSpec.ToRnnSpec());
+      }
+      else if (expert is RbfTrainRec)
+      {
+        var trainRec = (RbfTrainRec)expert;
+        var net = new RBFNet(trainRec.Bases.Select(b => b.ToRadialBasis()), trainRec.OutputBias, trainRec.Spread, trainRec.IsDegenerate);
+        RNNInterop.AddRbfMember(Ensemble, inputOffset, net);
+      }
+      else
+        throw new Exception("Unexpected expert type");
+    }
+
+    /// <summary>Callers go through t in order, so the whole input matrix is run on first use</summary>
+    public double Predict(int t)
+    {
+      if (Votes == null)
+        Votes = RNNInterop.PredictEnsemble(Ensemble, RowWiseInputs, NumColumns, 0, NumColumns, Environment.ProcessorCount).Votes;
+      return Votes[t];
+    }
+
+    public void Dispose()
+    {
+      Ensemble.Dispose();
+    }
+  }
+
+  class PredictorWithInputs : IPredictorWithInputs
+  {
+    readonly Mat Inputs;
+    readonly IPredictor Predictor;
+    Vec SequencePredictions;
+
+    public PredictorWithInputs(IPredictor predictor, Mat inputs)
+    {
+      Predictor = predictor;
+      Inputs = inputs;
+    }
+
+    /// <summary>Callers go through t in order, so a predictor that can run the whole input matrix
+    /// in one call does that on first use rather than crossing into native code once per column</summary>
+    public double Predict(int t)
+    {
+      var sequencePredictor = Predictor as ISequencePredictor;
+      if (sequencePredictor == null)
+        return Predictor.Predict(Inputs.Column(t));
+      if (SequencePredictions == null)
+        SequencePredictions = sequencePredictor.PredictSequence(Inputs);
+      return SequencePredictions[t];
+    }
+
+    public void Dispose()
+    {
+      Predictor.Dispose();
+    }
+  }
 }
\ No newline at end of file
@@ -1,170 +1,283 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Configuration;
-using System.Linq;
-using System.Threading.Tasks;
-using MongoDB.Bson;
-using Quqe.NewVersace;
-using Quqe.Rabbit;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
-using System.Diagnostics;
-
-namespace Quqe
-{
-  public interface IGenTrainer
-  {
-    void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress);
-  }
-
-  public class TrainProgress
-  {
-    public readonly int Completed;
-    public readonly int Total;
-
-    public TrainProgress(int completed, int total)
-    {
-      Completed = completed;
-      Total = total;
-    }
-  }
-
-  public class DataSet
-  {
-    public readonly Mat Input;
-    public readonly Vec Output;
-    public readonly int DatabaseAInputLength;
-
-    public DataSet(Mat input, Vec output, int databaseAInputLength)
-    {
-      Input = input;
-      Output = output;
-      DatabaseAInputLength = databaseAInputLength;
-    }
-  }
-
-  public class LocalTrainer : IGenTrainer
-  {
-    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
-    {
-      var total = population.Count() * population.First().Chromosomes.Length;
-      var numTrained = 0;
-      foreach (var mi in population)
-        foreach (var chrom in mi.Chromosomes)
-        {
-          TrainerCommon.Train(gen.Database, mi.MixtureId, data, chrom);
-          numTrained++;
-          progress(new TrainProgress(numTrained, total));
-        }
-    }
-  }
-
-  public class LocalParallelTrainer : IGenTrainer
-  {
-    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
-    {
-      var total = population.Count() * population.First().Chromosomes.Length;
-      var numTrained = 0;
-      var q = population.SelectMany(mixture => mixture.Chromosomes.Select(chrom => new { mixture, chrom })).ToList();
-
-      Parallel.ForEach(q, GetParallelOptions(), z => {
-        TrainerCommon.Train(gen.Database, z.mixture.MixtureId, data, z.chrom);
-        numTrained++;
-        progress(new TrainProgress(numTrained, total));
-      });
-    }
-
-    static ParallelOptions GetParallelOptions()
-    {
-      return new ParallelOptions { MaxDegreeOfParallelism = Environment.ProcessorCount };
-    }
-  }
-
-  public class DistributedTrainer : IGenTrainer
-  {
-    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
-    {
-      var hostInfo = RabbitHostInfo.FromAppSettings();
-      using (var trainRequests = new WorkQueueProducer(new WorkQueueInfo(hostInfo, "TrainRequests", false)))
-      using (var trainNotifications = new AsyncWorkQueueConsumer(new WorkQueueInfo(hostInfo, "TrainNotifications", false)))
-      {
-        List<TrainRequest> outstanding = (from mixture in population
-                                          from chrom in mixture.Chromosomes
-                                          select new TrainRequest(mixture.MixtureId.ToString(), chrom)).ToList();
-
-        int total = outstanding.Count;
-
-        var orderedRequests = outstanding.OrderByDescending(x => {
-          return Math.Pow(x.Chromosome.TrainingSizePct, 2)
-                 * (x.Chromosome.NetworkType == NetworkType.Rnn ? x.Chromosome.RnnTrainingEpochs : 100);
-        }).ToList();
-
-        trainNotifications.Received += msg => {
-          var notification = (TrainNotification)msg;
-          outstanding.RemoveAll(x => x.MixtureId == notification.OriginalRequest.MixtureId &&
-                                     x.Chromosome.OrderInMixture == notification.OriginalRequest.Chromosome.OrderInMixture);
-          progress(new TrainProgress(total - outstanding.Count, total));
-          trainNotifications.Ack(msg);
-        };
-
-        foreach (var req in orderedRequests)
-          trainRequests.Send(req);
-
-        Waiter.Wait(() => !outstanding.Any());
-      }
-    }
-  }
-
-  public delegate RnnTrainRec MakeRnnTrainRecFunc(Vec initialWeights, MRnnSpec rnnSpec, IEnumerable<double> costHistory);
-
-  public delegate RbfTrainRec MakeRbfTrainRecFunc(IEnumerable<MRadialBasis> bases, double outputBias, double spread, bool isDegenerate);
-
-  public static class TrainerCommon
-  {
-    public static void Train(Database db, ObjectId mixtureId, DataSet trainingSet, Chromosome chrom, Func<bool> cancelled = null)
-    {
-      var trimmed = TrimToWindow(trainingSet, chrom);
-      var tailoredData = DataTailoring.TailorInputs(trimmed.Input, trimmed.DatabaseAInputLength, chrom);
-
-      var sw = new Stopwatch();
-      sw.Start();
-      switch (chrom.NetworkType)
-      {
-        case NetworkType.Rnn:
-          Training.TrainRnn(tailoredData, trimmed.Output, chrom, (a, b, c) => new RnnTrainRec(db, mixtureId, chrom, sw.Elapsed.TotalSeconds, a, b, c), cancelled);
-          break;
-        case NetworkType.Rbf:
-          Training.TrainRbf(tailoredData, trimmed.Output, chrom, (a, b, c, d) => new RbfTrainRec(db, mixtureId, chrom, sw.Elapsed.TotalSeconds, a, b, c, d), cancelled);
-          break;
-        default:
-          throw new Exception("Unexpected network type: " + chrom.NetworkType);
-      }
-    }
-
-    static DataSet TrimToWindow(DataSet data, Chromosome chrom)
-    {
-      return new DataSet(TrimInputToWindow(data.Input, chrom),
-                         TrimOutputToWindow(data.Output, chrom),
-                         data.DatabaseAInputLength);
-    }
-
-    static Vec TrimOutputToWindow(Vec output, Chromosome chrom)
-    {
-      var w = GetDataWindowOffsetAndSize(output.Count, chrom);
-      return output.SubVector(w.Item1, w.Item2);
-    }
-
-    static Mat TrimInputToWindow(Mat inputs, Chromosome chrom)
-    {
-      var w = GetDataWindowOffsetAndSize(inputs.ColumnCount, chrom);
-      return inputs.Columns().Skip(w.Item1).Take(w.Item2).ColumnsToMatrix();
-    }
-
-    static Tuple2<int> GetDataWindowOffsetAndSize(int count, Chromosome chrom)
-    {
-      int offset = MathEx.Clamp(0, count - 1, (int)(chrom.TrainingOffsetPct * count));
-      int size = MathEx.Clamp(1, count - offset, (int)(chrom.TrainingSizePct * count));
-      return Tuple2.Create(offset, size);
-    }
-  }
+﻿using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Configuration;
+using System.Linq;
+using System.Threading;
+using System.Threading.Tasks;
+using MongoDB.Bson;
+using Quqe.NewVersace;
+using Quqe.Rabbit;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+using Mat = MathNet.Numerics.LinearAlgebra.Generic.Matrix<double>;
+using System.Diagnostics;
+
+namespace Quqe
+{
+  public interface IGenTrainer
+  {
+    void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress);
+  }
+
+  public class TrainProgress
+  {
+    public readonly int Completed;
+    public readonly int Total;
+
+    public TrainProgress(int completed, int total)
+    {
+      Completed = completed;
+      Total = total;
+    }
+  }
+
+  public class DataSet
+  {
+    public readonly Mat Input;
+    public readonly Vec Output;
+    public readonly int DatabaseAInputLength;
+
+    public DataSet(Mat input, Vec output, int databaseAInputLength)
+    {
+      Input = input;
+      Output = output;
+      DatabaseAInputLength = databaseAInputLength;
+    }
+
+    readonly Dictionary<Tuple<DatabaseType, bool>, RNNInterop.DataSetHandle> NativeDataSets =
+      new Dictionary<Tuple<DatabaseType, bool>, RNNInterop.DataSetHandle>();
+
+    /// <summary>The whole data set in native memory, tailored for chrom. Made on first use for each tailoring and
+    /// shared by every RNN trained on this data set, each reading its own training window in place.
+    /// Not for chromosomes that use PCA, whose tailoring depends on the training window</summary>
+    public RNNInterop.DataSetHandle GetNativeDataSet(Chromosome chrom)
+    {
+      Debug.Assert(!chrom.UsePCA);
+      var key = Tuple.Create(chrom.DatabaseType, chrom.UseComplementCoding);
+      lock (NativeDataSets)
+      {
+        RNNInterop.DataSetHandle handle;
+        if (!NativeDataSets.TryGetValue(key, out handle))
+        {
+          handle = RNNInterop.CreateDataSet(DataTailoring.TailorInputs(Input, DatabaseAInputLength, chrom), Output);
+          NativeDataSets.Add(key, handle);
+        }
+        return handle;
+      }
+    }
+  }
+
+  public class LocalTrainer : IGenTrainer
+  {
+    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
+    {
+      var total = population.Count() * population.First().Chromosomes.Length;
+      var numTrained = 0;
+      foreach (var mi in population)
+        foreach (var chrom in mi.Chromosomes)
+        {
+          TrainerCommon.Train(gen.Database, mi.MixtureId, data, chrom);
+          numTrained++;
+          progress(new TrainProgress(numTrained, total));
+        }
+    }
+  }
+
+  public class LocalParallelTrainer : IGenTrainer
+  {
+    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
+    {
+      var total = population.Count() * population.First().Chromosomes.Length;
+      var numTrained = 0;
+      Action trained = () => progress(new TrainProgress(Interlocked.Increment(ref numTrained), total));
+      var q = population.SelectMany(mixture => mixture.Chromosomes.Select(chrom => Tuple.Create(mixture.MixtureId, chrom))).ToList();
+
+      // the RNNs QuqeMath can train on its own threads go to its scheduler first, and the rest train alongside
+      // them, so neither group waits for the other to drain. The cores are split in proportion to each group's
+      // estimated work, so together they run about one thread per core
+      var native = q.Where(z => TrainerCommon.CanTrainNatively(z.Item2)).ToList();
+      var managed = q.Where(z => !TrainerCommon.CanTrainNatively(z.Item2)).ToList();
+      var nativeCost = native.Sum(z => TrainerCommon.EstimateTrainingCost(z.Item2));
+      var managedCost = managed.Sum(z => TrainerCommon.EstimateTrainingCost(z.Item2));
+      int numCores = Environment.ProcessorCount;
+      int nativeThreads = !managed.Any() ? numCores
+        : Math.Max(1, Math.Min(numCores - 1, (int)Math.Round(numCores * nativeCost / (nativeCost + managedCost))));
+      int managedThreads = Math.Max(1, numCores - nativeThreads);
+
+      var nativeTraining = native.Any()
+        ? Task.Factory.StartNew(() => TrainerCommon.TrainNatively(gen.Database, data, native, trained, nativeThreads),
+                                TaskCreationOptions.LongRunning)
+        : null;
+      try
+      {
+        Parallel.ForEach(managed, new ParallelOptions { MaxDegreeOfParallelism = managedThreads }, z => {
+          TrainerCommon.Train(gen.Database, z.Item1, data, z.Item2);
+          trained();
+        });
+      }
+      finally
+      {
+        if (nativeTraining != null)
+          nativeTraining.Wait();
+      }
+    }
+  }
+
+  public class DistributedTrainer : IGenTrainer
+  {
+    public void Train(DataSet data, Generation gen, IEnumerable<MixtureInfo> population, Action<TrainProgress> progress)
+    {
+      var hostInfo = RabbitHostInfo.FromAppSettings();
+      using (var trainRequests = new WorkQueueProducer(new WorkQueueInfo(hostInfo, "TrainRequests", false)))
+      using (var trainNotifications = new AsyncWorkQueueConsumer(new WorkQueueInfo(hostInfo, "TrainNotifications", false)))
+      {
+        List<TrainRequest> outstanding = (from mixture in population
+                                          from chrom in mixture.Chromosomes
+                                          select new TrainRequest(mixture.MixtureId.ToString(), chrom)).ToList();
+
+        int total = outstanding.Count;
+
+        var orderedRequests = outstanding.OrderByDescending(x => TrainerCommon.EstimateTrainingCost(x.Chromosome)).ToList();
+
+        trainNotifications.Received += msg => {
+          var notification = (TrainNotification)msg;
+          outstanding.RemoveAll(x => x.MixtureId == notification.OriginalRequest.MixtureId &&
+                                     x.Chromosome.OrderInMixture == notification.OriginalRequest.Chromosome.OrderInMixture);
+          progress(new TrainProgress(total - outstanding.Count, total));
+          trainNotifications.Ack(msg);
+        };
+
+        foreach (var req in orderedRequests)
+          trainRequests.Send(req);
+
+        Waiter.Wait(() => !outstanding.Any());
+      }
+    }
+  }
+
+  public delegate RnnTrainRec MakeRnnTrainRecFunc(Vec initialWeights, MRnnSpec rnnSpec, IEnumerable<double> costHistory, bool diverged);
+
+  public delegate RbfTrainRec MakeRbfTrainRecFunc(IEnumerable<MRadialBasis> bases, double outputBias, double spread, bool isDegenerate);
+
+  public static class TrainerCommon
+  {
+    public static void Train(Database db, ObjectId mixtureId, DataSet trainingSet, Chromosome chrom, Func<bool> cancelled = null)
+    {
+      var sw = new Stopwatch();
+      switch (chrom.NetworkType)
+      {
+        case NetworkType.Rnn:
+          MakeRnnTrainRecFunc makeRnnResult = (a, b, c, d) => new RnnTrainRec(db, mixtureId, chrom, sw.Elapsed.TotalSeconds, a, b, c, d);
+          if (chrom.UsePCA)
+          {
+            var trimmed = TrimToWindow(trainingSet, chrom);
+            var tailoredData = DataTailoring.TailorInputs(trimmed.Input, trimmed.DatabaseAInputLength, chrom);
+            sw.Start();
+            Training.TrainRnn(tailoredData, trimmed.Output, chrom, makeRnnResult, cancelled);
+          }
+          else
+          {
+            // without PCA, tailoring works column by column, so the window can be taken from the tailored whole
+            var w = GetDataWindowOffsetAndSize(trainingSet.Output.Count, chrom);
+            var data = trainingSet.GetNativeDataSet(chrom);
+            sw.Start();
+            Training.TrainRnn(data, w.Item1, w.Item2, chrom, makeRnnResult, cancelled);
+          }
+          break;
+        case NetworkType.Rbf:
+          {
+            var trimmed = TrimToWindow(trainingSet, chrom);
+            var tailoredData = DataTailoring.TailorInputs(trimmed.Input, trimmed.DatabaseAInputLength, chrom);
+            sw.Start();
+            Training.TrainRbf(tailoredData, trimmed.Output, chrom, (a, b, c, d) => new RbfTrainRec(db, mixtureId, chrom, sw.Elapsed.TotalSeconds, a, b, c, d), cancelled);
+          }
+          break;
+        default:
+          throw new Exception("Unexpected network type: " + chrom.NetworkType);
+      }
+    }
+
+    /// <summary>Relative training time, for running the longest first</summary>
+    public static double EstimateTrainingCost(Chromosome chrom)
+    {
+      return Math.Pow(chrom.TrainingSizePct, 2) * (chrom.NetworkType == NetworkType.Rnn ? chrom.RnnTrainingEpochs : 100);
+    }
+
+    /// <summary>RNNs without PCA train on the data set's shared native copy, so QuqeMath's TrainingScheduler can run them</summary>
+    public static bool CanTrainNatively(Chromosome chrom)
+    {
+      return chrom.NetworkType == NetworkType.Rnn && !chrom.UsePCA;
+    }
+
+    /// <summary>Trains each (mixture, chromosome) the way Train would, but on QuqeMath's work-stealing scheduler, longest
+    /// first. Results are stored on this thread as jobs finish, and trained is called after each. A job that stopped on
+    /// a non-finite evaluation is stored marked Diverged. numThreads 0 uses every core</summary>
+    public static void TrainNatively(Database db, DataSet trainingSet, IEnumerable<Tuple<ObjectId, Chromosome>> work,
+      Action trained, int numThreads = 0, Func<bool> cancelled = null)
+    {
+      var ordered = work.OrderByDescending(x => EstimateTrainingCost(x.Item2)).ToList();
+      using (var finished = new BlockingCollection<int>())
+      using (var scheduler = RNNInterop.CreateTrainingScheduler(numThreads, finished.Add))
+      {
+        // the scheduler numbers jobs from 0 in submission order
+        var initialWeights = new List<Vec>();
+        foreach (var x in ordered)
+        {
+          var chrom = x.Item2;
+          var layers = Training.MakeRnnLayers(chrom);
+          var data = trainingSet.GetNativeDataSet(chrom);
+          var w = GetDataWindowOffsetAndSize(trainingSet.Output.Count, chrom);
+          var weights = RNN.MakeRandomWeights(RNN.GetWeightCount(layers, data.NumInputs));
+          initialWeights.Add(weights);
+          scheduler.SubmitTrainingJob(layers, data, w.Item1, w.Item2, weights, chrom.RnnTrainingEpochs, RNN.SCGTau);
+        }
+
+        for (int i = 0; i < ordered.Count; i++)
+        {
+          int job;
+          while (!finished.TryTake(out job, 100))
+            if (cancelled != null && cancelled())
+              scheduler.CancelAllTrainingJobs();
+
+          var scg = scheduler.GetTrainingJobResult(job);
+          if (!scg.CostHistory.Any()) // canceled before it started
+            continue;
+          var chrom = ordered[job].Item2;
+          if (!scg.Status.IsOk)
+            Trace.WriteLine(string.Format("RNN training for mixture {0}, chromosome {1} stopped at epoch {2}: {3}",
+              ordered[job].Item1, chrom.OrderInMixture, scg.CostHistory.Count - 1, scg.Status));
+          var rnnSpec = new RNNSpec(trainingSet.GetNativeDataSet(chrom).NumInputs, Training.MakeRnnLayers(chrom), scg.Weights);
+          new RnnTrainRec(db, ordered[job].Item1, chrom, scg.Seconds, initialWeights[job], MRnnSpec.FromRnnSpec(rnnSpec), scg.CostHistory,
+                          !scg.Status.IsOk);
+          trained();
+        }
+      }
+    }
+
+    static DataSet TrimToWindow(DataSet data, Chromosome chrom)
+    {
+      return new DataSet(TrimInputToWindow(data.Input, chrom),
+                         TrimOutputToWindow(data.Output, chrom),
+                         data.DatabaseAInputLength);
+    }
+
+    static Vec TrimOutputToWindow(Vec output, Chromosome chrom)
+    {
+      var w = GetDataWindowOffsetAndSize(output.Count, chrom);
+      return output.SubVector(w.Item1, w.Item2);
+    }
+
+    static Mat TrimInputToWindow(Mat inputs, Chromosome chrom)
+    {
+      var w = GetDataWindowOffsetAndSize(inputs.ColumnCount, chrom);
+      return inputs.Columns().Skip(w.Item1).Take(w.Item2).ColumnsToMatrix();
+    }
+
+    static Tuple2<int> GetDataWindowOffsetAndSize(int count, Chromosome chrom)
+    {
+      int offset = MathEx.Clamp(0, count - 1, (int)(chrom.TrainingOffsetPct * count));
+      int size = MathEx.Clamp(1, count - offset, (int)(chrom.TrainingSizePct * count));
+      return Tuple2.Create(offset, size);
+    }
+  }
 }
\ No newline at end of file
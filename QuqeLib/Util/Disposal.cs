@@ -1,38 +1,38 @@
-﻿using System;
-using System.Linq;
-
-namespace Quqe
-{
-  public static class Disposal
-  {
-    public static void Dispose<T>(ref T obj)
-      where T : class, IDisposable
-    {
-      if (obj == null)
-        return;
-      obj.Dispose();
-      obj = null;
-    }
-
-    public static void DisposeSafely<T>(ref T obj)
-      where T : class, IDisposable
-    {
-      if (obj == null)
-        return;
-      try
-      {
-        obj.Dispose();
-      }
-      catch (Exception)
-      {
-      }
-      obj = null;
-    }
-
-    public static void All(params IDisposable[] objects)
-    {
-      foreach (var obj in objects.Where(x => x != null))
-        obj.Dispose();
-    }
-  }
-}
+﻿using System;
+using System.Linq;
+
+namespace Quqe
+{
+  public static class Disposal
+  {
+    public static void Dispose<T>(ref T obj)
+      where T : class, IDisposable
+    {
+      if (obj == null)
+        return;
+      obj.Dispose();
+      obj = null;
+    }
+
+    public static void DisposeSafely<T>(ref T obj)
+      where T : class, IDisposable
+    {
+      if (obj == null)
+        return;
+      try
+      {
+        obj.Dispose();
+      }
+      catch (Exception)
+      {
+      }
+      obj = null;
+    }
+
+    public static void All(params IDisposable[] objects)
+    {
+      foreach (var obj in objects.Where(x => x != null))
+        obj.Dispose();
+    }
+  }
+}
@@ -0,0 +1,488 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include <immintrin.h>
+#include "QuqeMath.h"
+
+// Vectorized logistic sigmoid and exp. exp(-x) is evaluated as 2^n * exp(r) with n = round(-x / ln 2) and
+// |r| <= ln(2)/2, using a degree-12 Taylor polynomial for exp(r). The truncation error is below
+// 2e-16 relative, so for x >= -708 the result is within 2 ulps of 1 / (1 + exp(-x)) computed
+// with libm. -x is clamped to [-708, 709] so 2^n never leaves the normal range, which means
+// x < -708 gives ~1e-308 instead of a denormal or 0. NaNs propagate.
+//
+// The float kernels work the same way with a degree-7 polynomial (error below 6e-9 relative) and
+// -x clamped to [-87, 88].
+//
+// exp(x) itself uses the same evaluation and clamps, so arguments below the clamp give the
+// smallest normal-range value rather than 0.
+//
+// Every kernel also reports whether all of its arguments were finite, testing x - x == 0 on the
+// vectors it has already loaded. The clamps map infinities to finite results, so the arguments
+// are the only place an overflowed activation still shows.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define QM_TARGET_AVX2
+#define QM_TARGET_AVX512
+#if _MSC_VER >= 1911
+#define QM_HAVE_AVX512
+#endif
+#else
+#include <cpuid.h>
+#define QM_TARGET_AVX2   __attribute__((target("avx2,fma")))
+#define QM_TARGET_AVX512 __attribute__((target("avx512f")))
+#define QM_HAVE_AVX512
+// GCC 12's avx512fintrin.h trips its own uninitialized-variable warning (GCC bug 105593)
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+static const double ExpArgMin = -708.0;
+static const double ExpArgMax = 709.0;
+static const double Log2e = 1.4426950408889634074;
+static const double Ln2Hi = 6.93145751953125e-1;
+static const double Ln2Lo = 1.42860682030941723212e-6;
+static const double ExpCoefficients[] = { // 1/k!, k = 12 down to 2
+	1.0 / 479001600, 1.0 / 39916800, 1.0 / 3628800, 1.0 / 362880, 1.0 / 40320, 1.0 / 5040,
+	1.0 / 720, 1.0 / 120, 1.0 / 24, 1.0 / 6, 1.0 / 2 };
+static const int NumExpCoefficients = sizeof(ExpCoefficients) / sizeof(ExpCoefficients[0]);
+
+static const float ExpArgMinF = -87.0f;
+static const float ExpArgMaxF = 88.0f;
+static const float Log2eF = 1.44269504f;
+static const float Ln2HiF = 0.693359375f;
+static const float Ln2LoF = -2.12194440e-4f;
+static const float ExpCoefficientsF[] = { // 1/k!, k = 7 down to 2
+	1.0f / 5040, 1.0f / 720, 1.0f / 120, 1.0f / 24, 1.0f / 6, 1.0f / 2 };
+static const int NumExpCoefficientsF = sizeof(ExpCoefficientsF) / sizeof(ExpCoefficientsF[0]);
+
+static bool LogisticSigmoidScalar(double* x, double* y, int n)
+{
+	int finite = 1;
+	for (int i = 0; i < n; i++)
+	{
+		finite &= x[i] - x[i] == 0;
+		y[i] = LogisticSigmoid(x[i]);
+	}
+	return finite != 0;
+}
+
+static bool ExpScalar(double* x, double* y, int n)
+{
+	int finite = 1;
+	for (int i = 0; i < n; i++)
+	{
+		finite &= x[i] - x[i] == 0;
+		y[i] = exp(x[i]);
+	}
+	return finite != 0;
+}
+
+// exp(v) = p * scale
+QM_TARGET_AVX2 static inline void Exp4Parts(__m256d v, __m256d& p, __m256d& scale)
+{
+	const __m256d one = _mm256_set1_pd(1.0);
+	// max/min return their second operand when either is NaN, so keep the argument second
+	v = _mm256_max_pd(_mm256_set1_pd(ExpArgMin), v);
+	v = _mm256_min_pd(_mm256_set1_pd(ExpArgMax), v);
+
+	__m256d nd = _mm256_round_pd(_mm256_mul_pd(v, _mm256_set1_pd(Log2e)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256d r = _mm256_fnmadd_pd(nd, _mm256_set1_pd(Ln2Hi), v);
+	r = _mm256_fnmadd_pd(nd, _mm256_set1_pd(Ln2Lo), r);
+
+	p = _mm256_set1_pd(ExpCoefficients[0]);
+	for (int k = 1; k < NumExpCoefficients; k++)
+		p = _mm256_fmadd_pd(p, r, _mm256_set1_pd(ExpCoefficients[k]));
+	p = _mm256_fmadd_pd(p, r, one);
+	p = _mm256_fmadd_pd(p, r, one);
+
+	// 2^n: adding 1.5 * 2^52 leaves n in the low mantissa bits
+	const __m256d shifter = _mm256_set1_pd(6755399441055744.0);
+	__m256i ni = _mm256_sub_epi64(_mm256_castpd_si256(_mm256_add_pd(nd, shifter)), _mm256_castpd_si256(shifter));
+	scale = _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_add_epi64(ni, _mm256_set1_epi64x(1023)), 52));
+}
+
+QM_TARGET_AVX2 static inline __m256d LogisticSigmoid4(__m256d x)
+{
+	const __m256d one = _mm256_set1_pd(1.0);
+	__m256d p, scale;
+	Exp4Parts(_mm256_sub_pd(_mm256_setzero_pd(), x), p, scale);
+	return _mm256_div_pd(one, _mm256_fmadd_pd(p, scale, one));
+}
+
+QM_TARGET_AVX2 static inline __m256d Exp4(__m256d x)
+{
+	__m256d p, scale;
+	Exp4Parts(x, p, scale);
+	return _mm256_mul_pd(p, scale);
+}
+
+// applies a 4-wide kernel to an array
+template <__m256d (*Kernel)(__m256d)>
+QM_TARGET_AVX2 static bool ApplyAvx2(double* x, double* y, int n)
+{
+	__m256d finite = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+	int i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d v = _mm256_loadu_pd(x + i);
+		finite = _mm256_and_pd(finite, _mm256_cmp_pd(_mm256_sub_pd(v, v), _mm256_setzero_pd(), _CMP_EQ_OQ));
+		_mm256_storeu_pd(y + i, Kernel(v));
+	}
+	if (i < n)
+	{
+		// run the tail through the same kernel so results don't depend on position. The padding is finite
+		double tail[4] = { 0, 0, 0, 0 };
+		memcpy(tail, x + i, (n - i) * sizeof(double));
+		__m256d v = _mm256_loadu_pd(tail);
+		finite = _mm256_and_pd(finite, _mm256_cmp_pd(_mm256_sub_pd(v, v), _mm256_setzero_pd(), _CMP_EQ_OQ));
+		_mm256_storeu_pd(tail, Kernel(v));
+		memcpy(y + i, tail, (n - i) * sizeof(double));
+	}
+	return _mm256_movemask_pd(finite) == 0xf;
+}
+
+static bool LogisticSigmoidScalarF(float* x, float* y, int n)
+{
+	int finite = 1;
+	for (int i = 0; i < n; i++)
+	{
+		finite &= x[i] - x[i] == 0;
+		y[i] = 1.0f / (1.0f + expf(-x[i]));
+	}
+	return finite != 0;
+}
+
+static bool ExpScalarF(float* x, float* y, int n)
+{
+	int finite = 1;
+	for (int i = 0; i < n; i++)
+	{
+		finite &= x[i] - x[i] == 0;
+		y[i] = expf(x[i]);
+	}
+	return finite != 0;
+}
+
+QM_TARGET_AVX2 static inline void Exp8FParts(__m256 v, __m256& p, __m256& scale)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	v = _mm256_max_ps(_mm256_set1_ps(ExpArgMinF), v);
+	v = _mm256_min_ps(_mm256_set1_ps(ExpArgMaxF), v);
+
+	__m256 nf = _mm256_round_ps(_mm256_mul_ps(v, _mm256_set1_ps(Log2eF)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m256 r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(Ln2HiF), v);
+	r = _mm256_fnmadd_ps(nf, _mm256_set1_ps(Ln2LoF), r);
+
+	p = _mm256_set1_ps(ExpCoefficientsF[0]);
+	for (int k = 1; k < NumExpCoefficientsF; k++)
+		p = _mm256_fmadd_ps(p, r, _mm256_set1_ps(ExpCoefficientsF[k]));
+	p = _mm256_fmadd_ps(p, r, one);
+	p = _mm256_fmadd_ps(p, r, one);
+
+	// n is in [-126, 127] after the clamp, so it converts exactly. NaN lanes give a garbage scale,
+	// but p is already NaN there
+	__m256i ni = _mm256_cvtps_epi32(nf);
+	scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(ni, _mm256_set1_epi32(127)), 23));
+}
+
+QM_TARGET_AVX2 static inline __m256 LogisticSigmoid8F(__m256 x)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	__m256 p, scale;
+	Exp8FParts(_mm256_sub_ps(_mm256_setzero_ps(), x), p, scale);
+	return _mm256_div_ps(one, _mm256_fmadd_ps(p, scale, one));
+}
+
+QM_TARGET_AVX2 static inline __m256 Exp8F(__m256 x)
+{
+	__m256 p, scale;
+	Exp8FParts(x, p, scale);
+	return _mm256_mul_ps(p, scale);
+}
+
+template <__m256 (*Kernel)(__m256)>
+QM_TARGET_AVX2 static bool ApplyAvx2F(float* x, float* y, int n)
+{
+	__m256 finite = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 v = _mm256_loadu_ps(x + i);
+		finite = _mm256_and_ps(finite, _mm256_cmp_ps(_mm256_sub_ps(v, v), _mm256_setzero_ps(), _CMP_EQ_OQ));
+		_mm256_storeu_ps(y + i, Kernel(v));
+	}
+	if (i < n)
+	{
+		float tail[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+		memcpy(tail, x + i, (n - i) * sizeof(float));
+		__m256 v = _mm256_loadu_ps(tail);
+		finite = _mm256_and_ps(finite, _mm256_cmp_ps(_mm256_sub_ps(v, v), _mm256_setzero_ps(), _CMP_EQ_OQ));
+		_mm256_storeu_ps(tail, Kernel(v));
+		memcpy(y + i, tail, (n - i) * sizeof(float));
+	}
+	return _mm256_movemask_ps(finite) == 0xff;
+}
+
+#ifdef QM_HAVE_AVX512
+// exp(v) before the final scaling by 2^n
+QM_TARGET_AVX512 static inline __m512d Exp8Parts(__m512d v, __m512d& nd)
+{
+	const __m512d one = _mm512_set1_pd(1.0);
+	v = _mm512_max_pd(_mm512_set1_pd(ExpArgMin), v);
+	v = _mm512_min_pd(_mm512_set1_pd(ExpArgMax), v);
+
+	nd = _mm512_roundscale_pd(_mm512_mul_pd(v, _mm512_set1_pd(Log2e)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m512d r = _mm512_fnmadd_pd(nd, _mm512_set1_pd(Ln2Hi), v);
+	r = _mm512_fnmadd_pd(nd, _mm512_set1_pd(Ln2Lo), r);
+
+	__m512d p = _mm512_set1_pd(ExpCoefficients[0]);
+	for (int k = 1; k < NumExpCoefficients; k++)
+		p = _mm512_fmadd_pd(p, r, _mm512_set1_pd(ExpCoefficients[k]));
+	p = _mm512_fmadd_pd(p, r, one);
+	return _mm512_fmadd_pd(p, r, one);
+}
+
+QM_TARGET_AVX512 static inline __m512d LogisticSigmoid8(__m512d x)
+{
+	const __m512d one = _mm512_set1_pd(1.0);
+	__m512d nd;
+	__m512d p = Exp8Parts(_mm512_sub_pd(_mm512_setzero_pd(), x), nd);
+	return _mm512_div_pd(one, _mm512_add_pd(_mm512_scalef_pd(p, nd), one));
+}
+
+QM_TARGET_AVX512 static inline __m512d Exp8(__m512d x)
+{
+	__m512d nd;
+	__m512d p = Exp8Parts(x, nd);
+	return _mm512_scalef_pd(p, nd);
+}
+
+template <__m512d (*Kernel)(__m512d)>
+QM_TARGET_AVX512 static bool ApplyAvx512(double* x, double* y, int n)
+{
+	__mmask8 nonFinite = 0;
+	int i = 0;
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d v = _mm512_loadu_pd(x + i);
+		nonFinite |= _mm512_cmp_pd_mask(_mm512_sub_pd(v, v), _mm512_setzero_pd(), _CMP_NEQ_UQ);
+		_mm512_storeu_pd(y + i, Kernel(v));
+	}
+	if (i < n)
+	{
+		// the masked-off lanes load as 0, which is finite
+		__mmask8 mask = (__mmask8)((1 << (n - i)) - 1);
+		__m512d v = _mm512_maskz_loadu_pd(mask, x + i);
+		nonFinite |= _mm512_cmp_pd_mask(_mm512_sub_pd(v, v), _mm512_setzero_pd(), _CMP_NEQ_UQ);
+		_mm512_mask_storeu_pd(y + i, mask, Kernel(v));
+	}
+	return nonFinite == 0;
+}
+
+QM_TARGET_AVX512 static inline __m512 Exp16FParts(__m512 v, __m512& nf)
+{
+	const __m512 one = _mm512_set1_ps(1.0f);
+	v = _mm512_max_ps(_mm512_set1_ps(ExpArgMinF), v);
+	v = _mm512_min_ps(_mm512_set1_ps(ExpArgMaxF), v);
+
+	nf = _mm512_roundscale_ps(_mm512_mul_ps(v, _mm512_set1_ps(Log2eF)), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+	__m512 r = _mm512_fnmadd_ps(nf, _mm512_set1_ps(Ln2HiF), v);
+	r = _mm512_fnmadd_ps(nf, _mm512_set1_ps(Ln2LoF), r);
+
+	__m512 p = _mm512_set1_ps(ExpCoefficientsF[0]);
+	for (int k = 1; k < NumExpCoefficientsF; k++)
+		p = _mm512_fmadd_ps(p, r, _mm512_set1_ps(ExpCoefficientsF[k]));
+	p = _mm512_fmadd_ps(p, r, one);
+	return _mm512_fmadd_ps(p, r, one);
+}
+
+QM_TARGET_AVX512 static inline __m512 LogisticSigmoid16F(__m512 x)
+{
+	const __m512 one = _mm512_set1_ps(1.0f);
+	__m512 nf;
+	__m512 p = Exp16FParts(_mm512_sub_ps(_mm512_setzero_ps(), x), nf);
+	return _mm512_div_ps(one, _mm512_add_ps(_mm512_scalef_ps(p, nf), one));
+}
+
+QM_TARGET_AVX512 static inline __m512 Exp16F(__m512 x)
+{
+	__m512 nf;
+	__m512 p = Exp16FParts(x, nf);
+	return _mm512_scalef_ps(p, nf);
+}
+
+template <__m512 (*Kernel)(__m512)>
+QM_TARGET_AVX512 static bool ApplyAvx512F(float* x, float* y, int n)
+{
+	__mmask16 nonFinite = 0;
+	int i = 0;
+	for (; i + 16 <= n; i += 16)
+	{
+		__m512 v = _mm512_loadu_ps(x + i);
+		nonFinite |= _mm512_cmp_ps_mask(_mm512_sub_ps(v, v), _mm512_setzero_ps(), _CMP_NEQ_UQ);
+		_mm512_storeu_ps(y + i, Kernel(v));
+	}
+	if (i < n)
+	{
+		__mmask16 mask = (__mmask16)((1 << (n - i)) - 1);
+		__m512 v = _mm512_maskz_loadu_ps(mask, x + i);
+		nonFinite |= _mm512_cmp_ps_mask(_mm512_sub_ps(v, v), _mm512_setzero_ps(), _CMP_NEQ_UQ);
+		_mm512_mask_storeu_ps(y + i, mask, Kernel(v));
+	}
+	return nonFinite == 0;
+}
+#endif
+
+typedef bool (*ActivationKernel)(double* x, double* y, int n);
+typedef bool (*ActivationKernelF)(float* x, float* y, int n);
+
+static void CpuId(int leaf, int subleaf, int regs[4])
+{
+#if defined(_MSC_VER)
+	__cpuidex(regs, leaf, subleaf);
+#else
+	unsigned int a, b, c, d;
+	__cpuid_count(leaf, subleaf, a, b, c, d);
+	regs[0] = a; regs[1] = b; regs[2] = c; regs[3] = d;
+#endif
+}
+
+static unsigned long long XGetBV()
+{
+#if defined(_MSC_VER)
+	return _xgetbv(0);
+#else
+	unsigned int lo, hi;
+	__asm__ ("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+	return ((unsigned long long)hi << 32) | lo;
+#endif
+}
+
+static int DetectActivationKernel()
+{
+	int regs[4];
+	CpuId(0, 0, regs);
+	if (regs[0] < 7)
+		return ACTIVATION_KERNEL_SCALAR;
+	CpuId(1, 0, regs);
+	bool osxsave = (regs[2] & (1 << 27)) != 0;
+	bool fma = (regs[2] & (1 << 12)) != 0;
+	if (!osxsave)
+		return ACTIVATION_KERNEL_SCALAR;
+	unsigned long long xcr0 = XGetBV();
+	CpuId(7, 0, regs);
+	bool avx2 = (regs[1] & (1 << 5)) != 0;
+	bool avx512f = (regs[1] & (1 << 16)) != 0;
+
+	bool ymmState = (xcr0 & 0x6) == 0x6;
+	bool zmmState = (xcr0 & 0xe6) == 0xe6;
+#ifdef QM_HAVE_AVX512
+	if (avx512f && zmmState)
+		return ACTIVATION_KERNEL_AVX512;
+#endif
+	if (avx2 && fma && ymmState)
+		return ACTIVATION_KERNEL_AVX2;
+	return ACTIVATION_KERNEL_SCALAR;
+}
+
+static const int BestActivationKernel = DetectActivationKernel();
+
+static ActivationKernel GetKernel(int kernel)
+{
+	switch (kernel)
+	{
+#ifdef QM_HAVE_AVX512
+	case ACTIVATION_KERNEL_AVX512: return ApplyAvx512<LogisticSigmoid8>;
+#endif
+	case ACTIVATION_KERNEL_AVX2: return ApplyAvx2<LogisticSigmoid4>;
+	default: return LogisticSigmoidScalar;
+	}
+}
+
+static ActivationKernelF GetKernelF(int kernel)
+{
+	switch (kernel)
+	{
+#ifdef QM_HAVE_AVX512
+	case ACTIVATION_KERNEL_AVX512: return ApplyAvx512F<LogisticSigmoid16F>;
+#endif
+	case ACTIVATION_KERNEL_AVX2: return ApplyAvx2F<LogisticSigmoid8F>;
+	default: return LogisticSigmoidScalarF;
+	}
+}
+
+static ActivationKernel GetExpKernel(int kernel)
+{
+	switch (kernel)
+	{
+#ifdef QM_HAVE_AVX512
+	case ACTIVATION_KERNEL_AVX512: return ApplyAvx512<Exp8>;
+#endif
+	case ACTIVATION_KERNEL_AVX2: return ApplyAvx2<Exp4>;
+	default: return ExpScalar;
+	}
+}
+
+static ActivationKernelF GetExpKernelF(int kernel)
+{
+	switch (kernel)
+	{
+#ifdef QM_HAVE_AVX512
+	case ACTIVATION_KERNEL_AVX512: return ApplyAvx512F<Exp16F>;
+#endif
+	case ACTIVATION_KERNEL_AVX2: return ApplyAvx2F<Exp8F>;
+	default: return ExpScalarF;
+	}
+}
+
+static const ActivationKernel LogisticSigmoidKernel = GetKernel(BestActivationKernel);
+static const ActivationKernelF LogisticSigmoidKernelF = GetKernelF(BestActivationKernel);
+static const ActivationKernel ExpKernel = GetExpKernel(BestActivationKernel);
+static const ActivationKernelF ExpKernelF = GetExpKernelF(BestActivationKernel);
+
+bool LogisticSigmoidVector(double* x, double* y, int n)
+{
+	return LogisticSigmoidKernel(x, y, n);
+}
+
+bool LogisticSigmoidVector(float* x, float* y, int n)
+{
+	return LogisticSigmoidKernelF(x, y, n);
+}
+
+bool ExpVector(double* x, double* y, int n)
+{
+	return ExpKernel(x, y, n);
+}
+
+bool ExpVector(float* x, float* y, int n)
+{
+	return ExpKernelF(x, y, n);
+}
+
+QUQEMATH_API int GetActivationKernel()
+{
+	return BestActivationKernel;
+}
+
+// kernel == -1 selects the best kernel for this CPU. Returns the kernel used, or -1 if the
+// requested one isn't supported here
+QUQEMATH_API int ApplyLogisticSigmoid(double* x, double* y, int n, int kernel)
+{
+	if (kernel == -1)
+		kernel = BestActivationKernel;
+	if (kernel < ACTIVATION_KERNEL_SCALAR || kernel > BestActivationKernel)
+		return -1;
+	GetKernel(kernel)(x, y, n);
+	return kernel;
+}
+
+// as ApplyLogisticSigmoid, for exp
+QUQEMATH_API int ApplyExp(double* x, double* y, int n, int kernel)
+{
+	if (kernel == -1)
+		kernel = BestActivationKernel;
+	if (kernel < ACTIVATION_KERNEL_SCALAR || kernel > BestActivationKernel)
+		return -1;
+	GetExpKernel(kernel)(x, y, n);
+	return kernel;
+}
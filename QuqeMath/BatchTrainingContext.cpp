@@ -0,0 +1,237 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+// Activations are stored per layer as one (BatchSize * NumSamples) x NodeCount slab, sequence-major then
+// timestep-major: row (b * NumSamples + t) holds sequence b at time t. Seen column-major, the B columns of
+// timestep t then form a NodeCount x B matrix starting at row t with leading dimension NumSamples * NodeCount,
+// so a layer step over the whole batch is a single GEMM, and each sequence's history is a contiguous block
+// for the gradient GEMMs.
+
+BatchTrainingContext::BatchTrainingContext(LayerSpec* specs, int nLayers, double* trainingData, double* outputData,
+	int nInputs, int nSamples, int* windowOffsets, int nWindows, int windowLength)
+{
+	BatchSize = nWindows;
+	NumSamples = windowLength;
+	NumInputs = nInputs;
+	NumLayers = nLayers;
+	LayerSpecs = new LayerSpec[nLayers];
+	memcpy(LayerSpecs, specs, nLayers * sizeof(LayerSpec));
+	Layers = SpecsToLayers<double>(nInputs, specs, nLayers);
+
+	Inputs = new Matrix(nWindows * windowLength, nInputs);
+	Outputs = new Matrix(nWindows, windowLength);
+	for (int b = 0; b < nWindows; b++)
+	{
+		int offset = windowOffsets[b];
+		assert(offset >= 0 && offset + windowLength <= nSamples);
+		for (int t = 0; t < windowLength; t++)
+			cblas_dcopy(nInputs, trainingData + offset + t, nSamples, GetRowPtr(Inputs, b * windowLength + t), 1);
+		memcpy(GetRowPtr(Outputs, b), outputData + offset, windowLength * sizeof(double));
+	}
+
+	A = new Matrix*[nLayers];
+	Z = new Matrix*[nLayers];
+	D = new Matrix*[nLayers];
+	int maxNodeCount = 0;
+	for (int l = 0; l < nLayers; l++)
+	{
+		int nodeCount = specs[l].NodeCount;
+		A[l] = new Matrix(nWindows * windowLength, nodeCount);
+		Z[l] = new Matrix(nWindows * windowLength, nodeCount);
+		D[l] = new Matrix(nWindows * windowLength, nodeCount);
+		if (nodeCount > maxNodeCount)
+			maxNodeCount = nodeCount;
+	}
+
+	TimeZeroRecurrentInput = new Matrix(nWindows, maxNodeCount);
+	for (int i = 0; i < TimeZeroRecurrentInput->DataLen; i++)
+		TimeZeroRecurrentInput->Data[i] = TimeZeroRecurrentInputValue;
+	Ones = new Vector(windowLength);
+	for (int t = 0; t < windowLength; t++)
+		Ones->Data[t] = 1;
+}
+
+BatchTrainingContext::~BatchTrainingContext()
+{
+	for (int l = 0; l < NumLayers; l++)
+	{
+		delete A[l];
+		delete Z[l];
+		delete D[l];
+	}
+	delete [] A;
+	delete [] Z;
+	delete [] D;
+	DeleteLayers(Layers, NumLayers, true);
+	delete [] LayerSpecs;
+	delete Inputs;
+	delete Outputs;
+	delete TimeZeroRecurrentInput;
+	delete Ones;
+}
+
+QUQEMATH_API void* CreateBatchTrainingContext(
+	LayerSpec* layerSpecs, int nLayers,
+	double* trainingData, double* outputData,
+	int nInputs, int nSamples,
+	int* windowOffsets, int nWindows, int windowLength)
+{
+	return new BatchTrainingContext(layerSpecs, nLayers, trainingData, outputData, nInputs, nSamples,
+		windowOffsets, nWindows, windowLength);
+}
+
+QUQEMATH_API void DestroyBatchTrainingContext(void* context)
+{
+	delete ((BatchTrainingContext*)context);
+}
+
+// C (m x B, column-major, leading dimension ldc) = alpha * op(W) * X + beta * C, where W is a row-major layer weight matrix
+static inline void BatchGEMM(CBLAS_TRANSPOSE transW, double alpha, Matrix* w, double* x, int ldx, double beta, double* c, int ldc, int nb)
+{
+	// a row-major matrix is its own transpose in column-major order
+	bool trans = transW == CblasNoTrans;
+	int m = trans ? w->RowCount : w->ColumnCount;
+	int k = trans ? w->ColumnCount : w->RowCount;
+	cblas_dgemm(CblasColMajor, trans ? CblasTrans : CblasNoTrans, CblasNoTrans, m, nb, k,
+		alpha, w->Data, w->ColumnCount, x, ldx, beta, c, ldc);
+}
+
+QUQEMATH_API void EvaluateWeightsBatch(BatchTrainingContext* c, double* weights, int nWeights,
+	double* outputs, double* errors, double* gradients)
+{
+	int nb = c->BatchSize;
+	int t_max = c->NumSamples - 1;
+	int numLayers = c->NumLayers;
+	int l_max = numLayers - 1;
+	Layer** layers = c->Layers;
+
+	// propagate inputs forward, one batch GEMM per layer per timestep
+	SetWeights(layers, numLayers, weights, nWeights);
+	for (int t = 0; t <= t_max; t++)
+	{
+		for (int l = 0; l < numLayers; l++)
+		{
+			Layer* layer = layers[l];
+			int nodeCount = layer->NodeCount;
+			int ld = c->NumSamples * nodeCount;
+			double* a = GetRowPtr(c->A[l], t);
+			double* z = GetRowPtr(c->Z[l], t);
+			double* x = l == 0 ? GetRowPtr(c->Inputs, t) : GetRowPtr(c->Z[l-1], t);
+			int ldx = c->NumSamples * layer->InputCount;
+
+			for (int b = 0; b < nb; b++)
+				memcpy(a + b * ld, layer->Bias->Data, nodeCount * sizeof(double));
+			BatchGEMM(CblasNoTrans, 1, layer->W, x, ldx, 1, a, ld, nb);
+			if (layer->IsRecurrent)
+			{
+				if (t > 0)
+					BatchGEMM(CblasNoTrans, 1, layer->Wr, z - nodeCount, ld, 1, a, ld, nb);
+				else
+					BatchGEMM(CblasNoTrans, 1, layer->Wr, c->TimeZeroRecurrentInput->Data, c->TimeZeroRecurrentInput->ColumnCount, 1, a, ld, nb);
+			}
+
+			for (int b = 0; b < nb; b++)
+			{
+				double* ab = a + b * ld;
+				double* zb = z + b * ld;
+				if (layer->ActivationType == ACTIVATION_LOGSIG)
+					LogisticSigmoidVector(ab, zb, nodeCount);
+				else // ACTIVATION_PURELIN
+					memcpy(zb, ab, nodeCount * sizeof(double));
+			}
+		}
+	}
+
+	Layer* lastLayer = layers[l_max];
+	int outputCount = lastLayer->NodeCount;
+	for (int b = 0; b < nb; b++)
+	{
+		memcpy(outputs + b * outputCount, GetRowPtr(c->Z[l_max], b * c->NumSamples + t_max), outputCount * sizeof(double));
+		errors[b] = 0;
+	}
+
+	// propagate error backward
+	for (int t = t_max; t >= 0; t--)
+	{
+		for (int l = l_max; l >= 0; l--)
+		{
+			Layer* layer = layers[l];
+			int nodeCount = layer->NodeCount;
+			int ld = c->NumSamples * nodeCount;
+			double* d = GetRowPtr(c->D[l], t);
+			double* z = GetRowPtr(c->Z[l], t);
+
+			// calculate error propagated to next layer
+			if (l == l_max)
+			{
+				for (int b = 0; b < nb; b++)
+				{
+					double target = c->Outputs->Data[b * c->NumSamples + t];
+					for (int i = 0; i < nodeCount; i++)
+					{
+						double err = target - z[b * ld + i];
+						d[b * ld + i] = err;
+						errors[b] += 0.5 * err * err;
+					}
+				}
+			}
+			else
+			{
+				Layer* subsequentLayer = layers[l + 1];
+				BatchGEMM(CblasTrans, 1, subsequentLayer->W, GetRowPtr(c->D[l + 1], t), c->NumSamples * subsequentLayer->NodeCount,
+					0, d, ld, nb);
+			}
+
+			// calculate error propagated forward in time (recurrently)
+			if (t < t_max && layer->IsRecurrent)
+				BatchGEMM(CblasTrans, 1, layer->Wr, d + nodeCount, ld, 1, d, ld, nb);
+
+			if (layer->ActivationType == ACTIVATION_LOGSIG)
+			{
+				for (int b = 0; b < nb; b++)
+					for (int i = b * ld; i < b * ld + nodeCount; i++)
+						d[i] *= z[i] * (1 - z[i]);
+			}
+			// else ACTIVATION_PURELIN, derivative is 1
+		}
+	}
+
+	// calculate each sequence's gradient, one GEMM over all timesteps per weight matrix.
+	// the flat layout matches SetWeights: W, then Wr if recurrent, then Bias, for each layer
+	int nt = c->NumSamples;
+	for (int b = 0; b < nb; b++)
+	{
+		double* gp = gradients + b * nWeights;
+		for (int l = 0; l < numLayers; l++)
+		{
+			Layer* layer = layers[l];
+			int nodeCount = layer->NodeCount;
+			int inputCount = layer->InputCount;
+			double* db = GetRowPtr(c->D[l], b * nt);
+			double* xb = l == 0 ? GetRowPtr(c->Inputs, b * nt) : GetRowPtr(c->Z[l-1], b * nt);
+
+			// W (row-major nodeCount x inputCount is column-major inputCount x nodeCount)
+			cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, inputCount, nodeCount, nt,
+				-1.0, xb, inputCount, db, nodeCount, 0, gp, inputCount);
+			gp += nodeCount * inputCount;
+
+			// Wr (no contribution from t = 0)
+			if (layer->IsRecurrent)
+			{
+				if (nt > 1)
+					cblas_dgemm(CblasColMajor, CblasNoTrans, CblasTrans, nodeCount, nodeCount, nt - 1,
+						-1.0, GetRowPtr(c->Z[l], b * nt), nodeCount, db + nodeCount, nodeCount, 0, gp, nodeCount);
+				else
+					memset(gp, 0, nodeCount * nodeCount * sizeof(double));
+				gp += nodeCount * nodeCount;
+			}
+
+			// Bias
+			cblas_dgemv(CblasColMajor, CblasNoTrans, nodeCount, nt, -1.0, db, nodeCount, c->Ones->Data, 1, 0, gp, 1);
+			gp += nodeCount;
+		}
+		assert(gp == gradients + (b + 1) * nWeights);
+	}
+}
@@ -0,0 +1,599 @@
+// Microbenchmarks for the QuqeMath hot paths, through the same C entry points the managed code uses.
+// Writes one JSON document so runs from different commits can be diffed:
+//
+//   quqemath-bench [--quick] [--min-time SECONDS] [--filter SUBSTRING] [--output FILE]
+//
+// ns_per_call is the median over several timed batches. gflops counts only the multiply-adds in the
+// BLAS calls (2 flops each), so it is comparable across commits but not with a BLAS's own figures.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include "QuqeMath.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+struct Options
+{
+	bool Quick;
+	double MinTime;
+	std::string Filter;
+	std::string OutputPath;
+};
+
+struct Measurement
+{
+	long long Calls;
+	double NsPerCall;
+	double NsPerCallMin;
+	double AllocationsPerCall;
+};
+
+static long PeakRssKB()
+{
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS pmc;
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+		return -1;
+	return (long)(pmc.PeakWorkingSetSize / 1024);
+#else
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) != 0)
+		return -1;
+	return usage.ru_maxrss; // kilobytes on Linux
+#endif
+}
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// size the batches to about a fifth of minTime each (which also warms up caches), then time five of them
+template <class F> static Measurement Measure(F f, double minTime)
+{
+	const int numBatches = 5;
+	long long batchSize = 1;
+	while (true)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long long i = 0; i < batchSize; i++)
+			f();
+		if (Seconds(start) >= minTime / numBatches || batchSize >= (1LL << 40))
+			break;
+		batchSize *= 2;
+	}
+
+	std::vector<double> nsPerCall;
+	int allocationsBefore = GetThreadAllocationCount();
+	for (int b = 0; b < numBatches; b++)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (long long i = 0; i < batchSize; i++)
+			f();
+		nsPerCall.push_back(Seconds(start) * 1e9 / batchSize);
+	}
+	int allocations = GetThreadAllocationCount() - allocationsBefore;
+
+	std::sort(nsPerCall.begin(), nsPerCall.end());
+	Measurement m;
+	m.Calls = batchSize * numBatches;
+	m.NsPerCall = nsPerCall[numBatches / 2];
+	m.NsPerCallMin = nsPerCall[0];
+	m.AllocationsPerCall = (double)allocations / m.Calls;
+	return m;
+}
+
+static std::vector<double> RandomVector(int n, double scale)
+{
+	std::vector<double> v(n);
+	for (int i = 0; i < n; i++)
+		v[i] = scale * (2.0 * rand() / RAND_MAX - 1);
+	return v;
+}
+
+static std::vector<LayerSpec> MakeLayerSpecs(int nodeCount, int depth, bool recurrent)
+{
+	std::vector<LayerSpec> specs;
+	for (int i = 0; i < depth; i++)
+	{
+		LayerSpec s = { nodeCount, recurrent, ACTIVATION_LOGSIG };
+		specs.push_back(s);
+	}
+	LayerSpec output = { 1, false, ACTIVATION_PURELIN };
+	specs.push_back(output);
+	return specs;
+}
+
+// multiply-adds for one timestep of the forward pass, times 2
+static double ForwardFlops(const std::vector<LayerSpec>& specs, int nInputs)
+{
+	double flops = 0;
+	int inputCount = nInputs;
+	for (size_t l = 0; l < specs.size(); l++)
+	{
+		int n = specs[l].NodeCount;
+		flops += 2.0 * n * inputCount;
+		if (specs[l].IsRecurrent)
+			flops += 2.0 * n * n;
+		inputCount = n;
+	}
+	return flops;
+}
+
+// forward pass, error backpropagation and gradient accumulation for a whole sequence
+static double EvaluateWeightsFlops(const std::vector<LayerSpec>& specs, int nInputs, int nSamples)
+{
+	double backward = 0;
+	for (size_t l = 0; l < specs.size(); l++)
+	{
+		int n = specs[l].NodeCount;
+		if (l + 1 < specs.size())
+			backward += 2.0 * n * specs[l + 1].NodeCount;
+		if (specs[l].IsRecurrent)
+			backward += 2.0 * n * n;
+	}
+	double forward = ForwardFlops(specs, nInputs);
+	return nSamples * (2 * forward + backward); // the gradient GEMMs cost the same as the forward pass
+}
+
+class JsonWriter
+{
+public:
+	JsonWriter(FILE* f) : F(f), First(true) {}
+
+	void Begin(const char* name)
+	{
+		Separator();
+		if (name != NULL)
+			fprintf(F, "\"%s\": ", name);
+		fprintf(F, "{");
+		First = true;
+	}
+
+	void BeginArray(const char* name)
+	{
+		Separator();
+		fprintf(F, "\"%s\": [", name);
+		First = true;
+	}
+
+	void End() { fprintf(F, "}"); First = false; }
+	void EndArray() { fprintf(F, "]"); First = false; }
+
+	void Field(const char* name, double v)
+	{
+		Separator();
+		fprintf(F, "\"%s\": %.6g", name, v);
+	}
+
+	void Field(const char* name, long long v)
+	{
+		Separator();
+		fprintf(F, "\"%s\": %lld", name, v);
+	}
+
+	void Field(const char* name, int v) { Field(name, (long long)v); }
+
+	void Field(const char* name, bool v)
+	{
+		Separator();
+		fprintf(F, "\"%s\": %s", name, v ? "true" : "false");
+	}
+
+	void Field(const char* name, const char* v)
+	{
+		Separator();
+		fprintf(F, "\"%s\": \"%s\"", name, v);
+	}
+
+private:
+	void Separator()
+	{
+		if (!First)
+			fprintf(F, ",");
+		fprintf(F, "\n");
+		First = false;
+	}
+
+	FILE* F;
+	bool First;
+};
+
+static void WriteMeasurement(JsonWriter& json, const Measurement& m, double flopsPerCall)
+{
+	json.Field("calls", m.Calls);
+	json.Field("ns_per_call", m.NsPerCall);
+	json.Field("ns_per_call_min", m.NsPerCallMin);
+	json.Field("gflops", flopsPerCall / m.NsPerCall);
+	json.Field("allocations_per_call", m.AllocationsPerCall);
+	json.Field("peak_rss_kb", (long long)PeakRssKB());
+}
+
+static const char* PhaseNames[] = { "setup", "set_weights", "forward", "backward", "gradient" };
+
+// where an evaluation's time went, from the context's own stats. Omitted if the library was built without them
+static void WritePhases(JsonWriter& json, TrainingContext* c)
+{
+	ContextStats stats;
+	if (!GetContextStats(c, &stats) || stats.Evaluations == 0)
+		return;
+	json.Begin("phases");
+	for (int p = PHASE_SET_WEIGHTS; p < PHASE_COUNT; p++)
+	{
+		json.Begin(PhaseNames[p]);
+		json.Field("ns_per_call", (double)stats.Phases[p].Nanoseconds / stats.Evaluations);
+		if (stats.Phases[p].Flops > 0)
+			json.Field("gflops", stats.Phases[p].Flops / stats.Phases[p].Nanoseconds);
+		json.End();
+	}
+	json.End();
+}
+
+static void WriteLayers(JsonWriter& json, int nInputs, const std::vector<LayerSpec>& specs)
+{
+	json.Field("inputs", nInputs);
+	json.BeginArray("layers");
+	for (size_t l = 0; l < specs.size(); l++)
+	{
+		json.Begin(NULL);
+		json.Field("nodes", specs[l].NodeCount);
+		json.Field("recurrent", specs[l].IsRecurrent);
+		json.Field("activation", specs[l].ActivationType == ACTIVATION_LOGSIG ? "logsig" : "purelin");
+		json.End();
+	}
+	json.EndArray();
+}
+
+static std::string Describe(const char* name, const std::vector<LayerSpec>& specs, int nSamples)
+{
+	std::string s = name;
+	char buf[64];
+	for (size_t l = 0; l < specs.size(); l++)
+	{
+		sprintf(buf, "%s%d%s", l == 0 ? " " : "-", specs[l].NodeCount, specs[l].IsRecurrent ? "r" : "");
+		s += buf;
+	}
+	if (nSamples > 0)
+	{
+		sprintf(buf, " T=%d", nSamples);
+		s += buf;
+	}
+	return s;
+}
+
+static bool Selected(const Options& opts, const std::string& description)
+{
+	return opts.Filter.empty() || description.find(opts.Filter) != std::string::npos;
+}
+
+static const char* PrecisionNames[] = { "double", "single", "mixed" };
+
+static void BenchEvaluateWeights(JsonWriter& json, const Options& opts)
+{
+	const int nInputs = 30;
+	std::vector<int> nodeCounts, depths, sampleCounts;
+	if (opts.Quick)
+	{
+		nodeCounts.push_back(2); nodeCounts.push_back(8);
+		depths.push_back(1); depths.push_back(2);
+		sampleCounts.push_back(50);
+	}
+	else
+	{
+		nodeCounts.push_back(2); nodeCounts.push_back(8); nodeCounts.push_back(32); nodeCounts.push_back(64);
+		depths.push_back(1); depths.push_back(2); depths.push_back(3);
+		sampleCounts.push_back(500); sampleCounts.push_back(3000);
+	}
+
+	for (size_t ni = 0; ni < nodeCounts.size(); ni++)
+	for (size_t di = 0; di < depths.size(); di++)
+	for (int recurrent = 1; recurrent >= 0; recurrent--)
+	for (size_t si = 0; si < sampleCounts.size(); si++)
+	for (int precision = PRECISION_DOUBLE; precision <= PRECISION_MIXED; precision++)
+	{
+		std::vector<LayerSpec> specs = MakeLayerSpecs(nodeCounts[ni], depths[di], recurrent != 0);
+		int nSamples = sampleCounts[si];
+		std::string description = Describe("EvaluateWeights", specs, nSamples) + " " + PrecisionNames[precision];
+		if (!Selected(opts, description))
+			continue;
+		fprintf(stderr, "%s\n", description.c_str());
+
+		int nLayers = (int)specs.size();
+		int nWeights = GetWeightCount(&specs[0], nLayers, nInputs);
+		std::vector<double> trainingData = RandomVector(nInputs * nSamples, 1);
+		std::vector<double> outputData = RandomVector(nSamples, 1);
+		std::vector<double> weights = RandomVector(nWeights, 0.1);
+		std::vector<double> gradient(nWeights);
+		double output, error;
+
+		TrainingContext* c = (TrainingContext*)CreateTrainingContext(&specs[0], nLayers,
+			&trainingData[0], &outputData[0], nInputs, nSamples, precision, 0, 0);
+		ResetContextStats(c);
+		Measurement m = Measure([&] {
+			EvaluateWeights(c, &weights[0], nWeights, &output, &error, &gradient[0]);
+		}, opts.MinTime);
+
+		json.Begin(NULL);
+		json.Field("name", "EvaluateWeights");
+		WriteLayers(json, nInputs, specs);
+		json.Field("samples", nSamples);
+		json.Field("precision", PrecisionNames[precision]);
+		WriteMeasurement(json, m, EvaluateWeightsFlops(specs, nInputs, nSamples));
+		WritePhases(json, c);
+		json.End();
+		DestroyTrainingContext(c);
+	}
+}
+
+static void BenchPropagateInput(JsonWriter& json, const Options& opts)
+{
+	const int nInputs = 30;
+	std::vector<int> nodeCounts, depths;
+	nodeCounts.push_back(2); nodeCounts.push_back(8);
+	depths.push_back(1); depths.push_back(2);
+	if (!opts.Quick)
+	{
+		nodeCounts.push_back(32); nodeCounts.push_back(64);
+		depths.push_back(3);
+	}
+
+	for (size_t ni = 0; ni < nodeCounts.size(); ni++)
+	for (size_t di = 0; di < depths.size(); di++)
+	for (int recurrent = 1; recurrent >= 0; recurrent--)
+	{
+		std::vector<LayerSpec> specs = MakeLayerSpecs(nodeCounts[ni], depths[di], recurrent != 0);
+		std::string description = Describe("PropagateInput", specs, 0);
+		if (!Selected(opts, description))
+			continue;
+		fprintf(stderr, "%s\n", description.c_str());
+
+		int nLayers = (int)specs.size();
+		int nWeights = GetWeightCount(&specs[0], nLayers, nInputs);
+		std::vector<double> weights = RandomVector(nWeights, 0.1);
+		std::vector<double> input = RandomVector(nInputs, 1);
+		double output;
+
+		PropagationContext* c = (PropagationContext*)CreatePropagationContext(&specs[0], nLayers, nInputs, &weights[0], nWeights);
+		Measurement m = Measure([&] {
+			PropagateInput(c, &input[0], &output);
+		}, opts.MinTime);
+		DestroyPropagationContext(c);
+
+		json.Begin(NULL);
+		json.Field("name", "PropagateInput");
+		WriteLayers(json, nInputs, specs);
+		WriteMeasurement(json, m, ForwardFlops(specs, nInputs));
+		json.End();
+	}
+}
+
+// the number of candidates orthogonalized per OrthogonalizeMany call
+static const int OrthoCandidates = 256;
+
+static void BenchOrthogonalize(JsonWriter& json, const Options& opts)
+{
+	std::vector<int> dimensions, basisCounts;
+	if (opts.Quick)
+	{
+		dimensions.push_back(100);
+		basisCounts.push_back(10);
+	}
+	else
+	{
+		dimensions.push_back(250); dimensions.push_back(1000); dimensions.push_back(3000);
+		basisCounts.push_back(10); basisCounts.push_back(100); basisCounts.push_back(500);
+	}
+
+	for (size_t di = 0; di < dimensions.size(); di++)
+	for (size_t bi = 0; bi < basisCounts.size(); bi++)
+	{
+		int dimension = dimensions[di];
+		int numBases = basisCounts[bi];
+		char description[64];
+		sprintf(description, "Orthogonalize dim=%d bases=%d", dimension, numBases);
+		if (!Selected(opts, description))
+			continue;
+		fprintf(stderr, "%s\n", description);
+
+		// only the cost matters here, so the bases needn't actually be orthonormal
+		std::vector<double> bases = RandomVector(dimension * numBases, 1.0 / dimension);
+		std::vector<double> p0 = RandomVector(dimension * OrthoCandidates, 1);
+		std::vector<double> p(dimension * OrthoCandidates);
+
+		OrthoContext* c = (OrthoContext*)CreateOrthoContext(dimension, numBases);
+		for (int b = 0; b < numBases; b++)
+			AppendBasis(c, &bases[b * dimension]);
+		Measurement single = Measure([&] {
+			memcpy(&p[0], &p0[0], dimension * sizeof(double));
+			Orthogonalize(c, &p[0]);
+		}, opts.MinTime);
+		Measurement many = Measure([&] {
+			memcpy(&p[0], &p0[0], p.size() * sizeof(double));
+			OrthogonalizeMany(c, &p[0], OrthoCandidates);
+		}, opts.MinTime);
+		DestroyOrthoContext(c);
+
+		json.Begin(NULL);
+		json.Field("name", "Orthogonalize");
+		json.Field("basis_dimension", dimension);
+		json.Field("bases", numBases);
+		WriteMeasurement(json, single, 4.0 * dimension * numBases + 3.0 * dimension);
+		json.End();
+
+		json.Begin(NULL);
+		json.Field("name", "OrthogonalizeMany");
+		json.Field("basis_dimension", dimension);
+		json.Field("bases", numBases);
+		json.Field("candidates", OrthoCandidates);
+		WriteMeasurement(json, many, OrthoCandidates * (4.0 * dimension * numBases + 3.0 * dimension));
+		json.End();
+	}
+}
+
+static void BenchGaussianKernel(JsonWriter& json, const Options& opts)
+{
+	const int nInputs = 8;
+	std::vector<int> sizes;
+	sizes.push_back(250);
+	if (!opts.Quick)
+	{
+		sizes.push_back(1000); sizes.push_back(3000);
+	}
+
+	for (size_t si = 0; si < sizes.size(); si++)
+	for (int single = 0; single <= 1; single++)
+	{
+		// every input is also a center, as in RBF training
+		int n = sizes[si];
+		char description[64];
+		sprintf(description, "GaussianKernelMatrix n=%d %s", n, single ? "single" : "double");
+		if (!Selected(opts, description))
+			continue;
+		fprintf(stderr, "%s\n", description);
+
+		std::vector<double> inputs = RandomVector(nInputs * n, 1);
+		std::vector<double> centers(n * nInputs);
+		for (int j = 0; j < n; j++)
+			for (int r = 0; r < nInputs; r++)
+				centers[j * nInputs + r] = inputs[r * n + j];
+		std::vector<double> k(single ? 0 : n * n);
+		std::vector<float> kf(single ? n * n : 0);
+
+		Measurement m = Measure([&] {
+			if (single)
+				GaussianKernelMatrixF(&centers[0], n, nInputs, &inputs[0], n, 0, 1.0, &kf[0], 0);
+			else
+				GaussianKernelMatrix(&centers[0], n, nInputs, &inputs[0], n, 0, 1.0, &k[0], 0);
+		}, opts.MinTime);
+
+		json.Begin(NULL);
+		json.Field("name", "GaussianKernelMatrix");
+		json.Field("inputs", nInputs);
+		json.Field("centers", n);
+		json.Field("samples", n);
+		json.Field("precision", PrecisionNames[single]);
+		WriteMeasurement(json, m, (2.0 * nInputs + 3.0) * n * n);
+		json.End();
+	}
+}
+
+// A generation's worth of uneven training jobs, a few long and many short, on one thread and on every thread
+static void BenchTrainingScheduler(JsonWriter& json, const Options& opts)
+{
+	const int nInputs = 30;
+	const int nSamples = opts.Quick ? 100 : 1000;
+	const int nJobs = opts.Quick ? 8 : 64;
+	std::vector<LayerSpec> specs = MakeLayerSpecs(8, 2, true);
+	int nLayers = (int)specs.size();
+	int nWeights = GetWeightCount(&specs[0], nLayers, nInputs);
+	std::vector<double> trainingData = RandomVector(nInputs * nSamples, 1);
+	std::vector<double> outputData = RandomVector(nSamples, 1);
+	std::vector<double> weights = RandomVector(nWeights, 0.1);
+	SharedDataSet* data = (SharedDataSet*)CreateDataSet(&trainingData[0], &outputData[0], nInputs, nSamples);
+
+	int hardwareThreads = (int)std::thread::hardware_concurrency();
+	for (int all = 0; all <= 1; all++)
+	{
+		int nThreads = all ? hardwareThreads : 1;
+		char description[64];
+		sprintf(description, "TrainingScheduler jobs=%d threads=%d", nJobs, nThreads);
+		if (!Selected(opts, description) || (all && nThreads <= 1))
+			continue;
+		fprintf(stderr, "%s\n", description);
+
+		Measurement m = Measure([&] {
+			TrainingScheduler* s = (TrainingScheduler*)CreateTrainingScheduler(nThreads, NULL, NULL);
+			for (int j = 0; j < nJobs; j++)
+			{
+				// longest first, as callers are meant to submit them
+				int epochs = j < nJobs / 8 ? 40 : 5;
+				int length = j % 2 == 0 ? nSamples : nSamples / 2;
+				SubmitTrainingJob(s, &specs[0], nLayers, data, 0, length, PRECISION_DOUBLE, 0, 0,
+					&weights[0], nWeights, epochs, 0);
+			}
+			WaitForTrainingJobs(s);
+			DestroyTrainingScheduler(s);
+		}, opts.MinTime);
+
+		json.Begin(NULL);
+		json.Field("name", "TrainingScheduler");
+		WriteLayers(json, nInputs, specs);
+		json.Field("samples", nSamples);
+		json.Field("jobs", nJobs);
+		json.Field("threads", nThreads);
+		WriteMeasurement(json, m, 0);
+		json.End();
+	}
+	ReleaseDataSet(data);
+}
+
+static void Usage()
+{
+	fprintf(stderr, "usage: quqemath-bench [--quick] [--min-time SECONDS] [--filter SUBSTRING] [--output FILE]\n");
+	exit(2);
+}
+
+int main(int argc, char** argv)
+{
+	Options opts;
+	opts.Quick = false;
+	opts.MinTime = -1;
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--quick") == 0)
+			opts.Quick = true;
+		else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc)
+			opts.MinTime = atof(argv[++i]);
+		else if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+			opts.Filter = argv[++i];
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			opts.OutputPath = argv[++i];
+		else
+			Usage();
+	}
+	if (opts.MinTime < 0)
+		opts.MinTime = opts.Quick ? 0.01 : 0.25;
+
+	FILE* f = stdout;
+	if (!opts.OutputPath.empty())
+	{
+		f = fopen(opts.OutputPath.c_str(), "w");
+		if (f == NULL)
+		{
+			fprintf(stderr, "can't open %s\n", opts.OutputPath.c_str());
+			return 1;
+		}
+	}
+
+	srand(1);
+	JsonWriter json(f);
+	json.Begin(NULL);
+	json.Field("activation_kernel", GetActivationKernel());
+	json.Field("pointer_bits", (int)(8 * sizeof(void*)));
+	json.Field("quick", opts.Quick);
+	json.Field("min_time", opts.MinTime);
+	json.BeginArray("results");
+	BenchEvaluateWeights(json, opts);
+	BenchPropagateInput(json, opts);
+	BenchOrthogonalize(json, opts);
+	BenchGaussianKernel(json, opts);
+	BenchTrainingScheduler(json, opts);
+	json.EndArray();
+	json.Field("peak_rss_kb", (long long)PeakRssKB());
+	json.End();
+	fprintf(f, "\n");
+
+	if (f != stdout)
+		fclose(f);
+	return 0;
+}
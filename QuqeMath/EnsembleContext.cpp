@@ -0,0 +1,151 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include <math.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+EnsembleMember::EnsembleMember(int inputOffset, int nInputs)
+{
+	InputOffset = inputOffset;
+	NumInputs = nInputs;
+	Rnn = NULL;
+	Centers = NULL;
+	Weights = NULL;
+	OutputBias = 0;
+	Spread = 1;
+	IsDegenerate = false;
+}
+
+EnsembleMember::~EnsembleMember()
+{
+	delete Rnn;
+	delete Centers;
+	delete Weights;
+}
+
+// inputs points at this member's first input row. outputs receives one value per step
+void EnsembleMember::Predict(double* inputs, int nSteps, int ldInputs, double* outputs)
+{
+	if (Rnn != NULL)
+	{
+		PropagateSequence(Rnn, inputs, NumInputs, nSteps, outputs, ldInputs);
+		return;
+	}
+
+	if (IsDegenerate)
+	{
+		for (int t = 0; t < nSteps; t++)
+			outputs[t] = 0;
+		return;
+	}
+
+	RbfPredict(Centers->Data, Weights->Data, Centers->RowCount, NumInputs, OutputBias, Spread,
+		inputs, nSteps, ldInputs, outputs);
+}
+
+EnsembleContext::EnsembleContext(int nInputs, int maxMembers)
+{
+	NumInputs = nInputs;
+	MaxMembers = maxMembers;
+	NumMembers = 0;
+	Members = new EnsembleMember*[maxMembers];
+}
+
+EnsembleContext::~EnsembleContext()
+{
+	for (int m = 0; m < NumMembers; m++)
+		delete Members[m];
+	delete [] Members;
+}
+
+QUQEMATH_API void* CreateEnsembleContext(int nInputs, int maxMembers)
+{
+	return new EnsembleContext(nInputs, maxMembers);
+}
+
+QUQEMATH_API void DestroyEnsembleContext(void* context)
+{
+	delete ((EnsembleContext*)context);
+}
+
+QUQEMATH_API int AddRnnMember(EnsembleContext* c, int inputOffset, LayerSpec* layerSpecs, int nLayers, int nInputs,
+	double* weights, int nWeights)
+{
+	assert(c->NumMembers < c->MaxMembers);
+	assert(inputOffset >= 0 && inputOffset + nInputs <= c->NumInputs);
+	assert(layerSpecs[nLayers-1].NodeCount == 1);
+	EnsembleMember* m = new EnsembleMember(inputOffset, nInputs);
+	m->Rnn = new PropagationContext(layerSpecs, nLayers, nInputs, weights, nWeights);
+	c->Members[c->NumMembers] = m;
+	return c->NumMembers++;
+}
+
+// centers is nCenters x nInputs, row-major, one center per row
+QUQEMATH_API int AddRbfMember(EnsembleContext* c, int inputOffset, int nInputs, double* centers, double* weights,
+	int nCenters, double outputBias, double spread, int isDegenerate)
+{
+	assert(c->NumMembers < c->MaxMembers);
+	assert(inputOffset >= 0 && inputOffset + nInputs <= c->NumInputs);
+	EnsembleMember* m = new EnsembleMember(inputOffset, nInputs);
+	m->Centers = new Matrix(nCenters, nInputs, centers);
+	m->Weights = new Vector(nCenters, weights);
+	m->OutputBias = outputBias;
+	m->Spread = spread;
+	m->IsDegenerate = isDegenerate != 0;
+	c->Members[c->NumMembers] = m;
+	return c->NumMembers++;
+}
+
+// Runs every member over nSteps columns of inputs, which is NumInputs x nSteps, row-major with rows ldInputs apart
+// (0 means nSteps). memberOutputs is NumMembers x nSteps, row-major. votes[t] is the sign of the members' average
+// at t, 0 if it is 0 or NaN. Members are shared out among nThreads threads; each member's outputs depend only on
+// its own state, so the result is the same for any thread count. RNN members carry their state into the next call
+QUQEMATH_API void EnsemblePredict(EnsembleContext* c, double* inputs, int nSteps, int ldInputs,
+	double* memberOutputs, double* votes, int nThreads)
+{
+	if (ldInputs == 0)
+		ldInputs = nSteps;
+	assert(ldInputs >= nSteps);
+	if (nThreads > c->NumMembers)
+		nThreads = c->NumMembers;
+
+	std::atomic<int> nextMember(0);
+	auto work = [&]() {
+		for (int m = nextMember++; m < c->NumMembers; m = nextMember++)
+		{
+			EnsembleMember* member = c->Members[m];
+			member->Predict(inputs + member->InputOffset * ldInputs, nSteps, ldInputs, memberOutputs + m * nSteps);
+		}
+	};
+
+	if (nThreads <= 1)
+		work();
+	else
+	{
+		std::vector<std::thread> threads;
+		for (int i = 1; i < nThreads; i++)
+			threads.push_back(std::thread(work));
+		work();
+		for (size_t i = 0; i < threads.size(); i++)
+			threads[i].join();
+	}
+
+	for (int t = 0; t < nSteps; t++)
+	{
+		double sum = 0;
+		for (int m = 0; m < c->NumMembers; m++)
+			sum += memberOutputs[m * nSteps + t];
+		double average = sum / c->NumMembers;
+		votes[t] = average > 0 ? 1 : average < 0 ? -1 : 0;
+	}
+}
+
+QUQEMATH_API void ResetEnsembleState(EnsembleContext* c)
+{
+	for (int m = 0; m < c->NumMembers; m++)
+		if (c->Members[m]->Rnn != NULL)
+			ResetState(c->Members[m]->Rnn);
+}
@@ -1,112 +1,129 @@
-#include "stdafx.h"
-#include <stdio.h>
-#include "QuqeMath.h"
-#include "LinReg.h"
-
-Layer::Layer(Matrix* w, Matrix* wr, Vector* bias, bool isRecurrent, int activationType)
-{
-	W = w;
-	Wr = wr;
-	Bias = bias;
-	NodeCount = W->RowCount;
-	InputCount = W->ColumnCount;
-	x = new Vector(InputCount);
-	x->Zero();
-	a = new Vector(NodeCount);
-	a->Zero();
-	z = new Vector(NodeCount);
-	z->Zero();
-	d = new Vector(NodeCount);
-	d->Zero();
-	IsRecurrent = isRecurrent;
-	ActivationType = activationType;
-}
-
-void Layer::DeleteWeights()
-{
-	delete W;
-	if (Wr != NULL)
-		delete Wr;
-	delete Bias;
-}
-
-Layer::~Layer()
-{
-	delete x;
-	delete a;
-	delete z;
-	delete d;
-}
-
-Frame::Frame(Layer** layers, int numLayers)
-{
-	Layers = layers;
-	NumLayers = numLayers;
-}
-
-Frame::~Frame()
-{
-	if (Layers != NULL)
-		DeleteLayers(Layers, NumLayers, false);
-}
-
-Frame** LayersToFrames(Layer** protoLayers, int nLayers, int nSamples)
-{
-	Frame** frames = new Frame*[nSamples];
-	for (int t = 0; t < nSamples; t++)
-	{
-		Layer** layers = new Layer*[nLayers];
-		for (int l = 0; l < nLayers; l++)
-		{
-			Layer* pl = protoLayers[l];
-			layers[l] = new Layer(pl->W, pl->Wr, pl->Bias, pl->IsRecurrent, pl->ActivationType);
-		}
-		frames[t] = new Frame(layers, nLayers);
-	}
-	return frames;
-}
-
-void DeleteFrames(Frame** frames, int nSamples)
-{
-	int nLayers = frames[0]->NumLayers;
-	for (int l = 0; l < nLayers; l++)
-		frames[0]->Layers[l]->DeleteWeights();
-	int t_max = nSamples;
-	for (int t = 0; t < t_max; t++)
-		delete frames[t];
-	delete [] frames;
-}
-
-// delete everything but the weights. those are deleted by DeleteFrames()
-void DeleteLayers(Layer** layers, int nLayers, bool deleteWeights)
-{
-	for (int l = 0; l < nLayers; l++)
-	{
-		if (deleteWeights)
-			layers[l]->DeleteWeights();
-		delete layers[l];
-	}
-	delete [] layers;
-}
-
-Layer** SpecsToLayers(int numInputs, LayerSpec* specs, int numLayers)
-{
-	Layer** layers = new Layer*[numLayers];
-	for (int l = 0; l < numLayers; l++)
-	{
-		LayerSpec* s = &specs[l];
-
-		Matrix* w = new Matrix(s->NodeCount, l > 0 ? specs[l-1].NodeCount : numInputs);
-		w->Zero();
-		Matrix* wr = NULL;
-		if (s->IsRecurrent)
-		{
-			wr = new Matrix(s->NodeCount, s->NodeCount);
-			wr->Zero();
-		}
-		Vector* bias = new Vector(s->NodeCount);
-		bias->Zero();
-		layers[l] = new Layer(w, wr, bias, s->IsRecurrent, s->ActivationType);
-	}
-	return layers;
-}
\ No newline at end of file
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+template <typename T>
+LayerT<T>::LayerT(MatrixT<T>* w, MatrixT<T>* wr, VectorT<T>* bias, bool isRecurrent, int activationType,
+	bool hasStepState)
+{
+	W = w;
+	Wr = wr;
+	Bias = bias;
+	NodeCount = W->RowCount;
+	InputCount = W->ColumnCount;
+	a = NULL;
+	z = NULL;
+	if (hasStepState)
+	{
+		a = new VectorT<T>(NodeCount);
+		a->Zero();
+		z = new VectorT<T>(NodeCount);
+		z->Zero();
+	}
+	IsRecurrent = isRecurrent;
+	ActivationType = activationType;
+}
+
+template <typename T>
+void LayerT<T>::DeleteWeights()
+{
+	delete W;
+	if (Wr != NULL)
+		delete Wr;
+	delete Bias;
+}
+
+template <typename T>
+LayerT<T>::~LayerT()
+{
+	delete a;
+	delete z;
+}
+
+template <typename T>
+void DeleteLayers(LayerT<T>** layers, int nLayers, bool deleteWeights)
+{
+	for (int l = 0; l < nLayers; l++)
+	{
+		if (deleteWeights)
+			layers[l]->DeleteWeights();
+		delete layers[l];
+	}
+	delete [] layers;
+}
+
+template <typename T>
+LayerT<T>** SpecsToLayers(int numInputs, LayerSpec* specs, int numLayers)
+{
+	LayerT<T>** layers = new LayerT<T>*[numLayers];
+	for (int l = 0; l < numLayers; l++)
+	{
+		LayerSpec* s = &specs[l];
+
+		MatrixT<T>* w = new MatrixT<T>(s->NodeCount, l > 0 ? specs[l-1].NodeCount : numInputs);
+		w->Zero();
+		MatrixT<T>* wr = NULL;
+		if (s->IsRecurrent)
+		{
+			wr = new MatrixT<T>(s->NodeCount, s->NodeCount);
+			wr->Zero();
+		}
+		VectorT<T>* bias = new VectorT<T>(s->NodeCount);
+		bias->Zero();
+		layers[l] = new LayerT<T>(w, wr, bias, s->IsRecurrent, s->ActivationType, true);
+	}
+	return layers;
+}
+
+// layers whose W, Wr and Bias are views into weights, in the SetWeights layout. They have no step state, and
+// with NULL weights they view nothing until BindLayerViews
+template <typename T>
+LayerT<T>** SpecsToLayerViews(int numInputs, LayerSpec* specs, int numLayers, T* weights)
+{
+	LayerT<T>** layers = new LayerT<T>*[numLayers];
+	for (int l = 0; l < numLayers; l++)
+	{
+		LayerSpec* s = &specs[l];
+		int inputCount = l > 0 ? specs[l-1].NodeCount : numInputs;
+
+		MatrixT<T>* w = MatrixT<T>::View(s->NodeCount, inputCount, NULL);
+		MatrixT<T>* wr = s->IsRecurrent ? MatrixT<T>::View(s->NodeCount, s->NodeCount, NULL) : NULL;
+		VectorT<T>* bias = VectorT<T>::View(s->NodeCount, NULL);
+		layers[l] = new LayerT<T>(w, wr, bias, s->IsRecurrent, s->ActivationType, false);
+	}
+	if (weights != NULL)
+		BindLayerViews(layers, numLayers, weights);
+	return layers;
+}
+
+// points layer views at another flat weight vector, in the SetWeights layout. Nothing is copied
+template <typename T>
+void BindLayerViews(LayerT<T>** layers, int numLayers, T* weights)
+{
+	T* wp = weights;
+	for (int l = 0; l < numLayers; l++)
+	{
+		LayerT<T>* layer = layers[l];
+		layer->W->Data = wp;
+		wp += layer->NodeCount * layer->InputCount;
+		if (layer->Wr != NULL)
+		{
+			layer->Wr->Data = wp;
+			wp += layer->NodeCount * layer->NodeCount;
+		}
+		layer->Bias->Data = wp;
+		wp += layer->NodeCount;
+	}
+}
+
+template class LayerT<double>;
+template class LayerT<float>;
+template void DeleteLayers(LayerT<double>** layers, int nLayers, bool deleteWeights);
+template void DeleteLayers(LayerT<float>** layers, int nLayers, bool deleteWeights);
+template LayerT<double>** SpecsToLayers<double>(int numInputs, LayerSpec* specs, int numLayers);
+template LayerT<float>** SpecsToLayers<float>(int numInputs, LayerSpec* specs, int numLayers);
+template LayerT<double>** SpecsToLayerViews<double>(int numInputs, LayerSpec* specs, int numLayers, double* weights);
+template LayerT<float>** SpecsToLayerViews<float>(int numInputs, LayerSpec* specs, int numLayers, float* weights);
+template void BindLayerViews(LayerT<double>** layers, int numLayers, double* weights);
+template void BindLayerViews(LayerT<float>** layers, int numLayers, float* weights);
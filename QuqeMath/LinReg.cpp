@@ -1,93 +1,146 @@
-#include "stdafx.h"
-#include "LinReg.h"
-#include <exception>
-
-Vector::Vector(int count)
-{
-  Count = count;
-  Data = (double*)_aligned_malloc(count * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-}
-
-Vector::Vector(int count, double* data)
-{
-  Count = count;
-  Data = (double*)_aligned_malloc(count * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-  memcpy(Data, data, count * sizeof(double));
-}
-
-Vector::Vector(const Vector &v)
-{
-  Count = v.Count;
-  Data = (double*)_aligned_malloc(Count * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-  memcpy(Data, v.Data, Count * sizeof(double));
-}
-
-void Vector::Set(Vector* v)
-{
-  cblas_dcopy(v->Count, v->Data, 1, Data, 1);
-}
-
-void Vector::Set(double* data, int stride, int count)
-{
-  cblas_dcopy(count, data, stride, Data, 1);
-}
-
-void Vector::Zero()
-{
-  memset(Data, 0, Count * sizeof(double));
-}
-
-Vector::~Vector()
-{
-  if (Data != NULL)
-    _aligned_free(Data);
-}
-
-Matrix::Matrix(int nRows, int nCols)
-{
-  RowCount = nRows;
-  ColumnCount = nCols;
-  DataLen = nRows * nCols;
-  Data = (double*)_aligned_malloc(DataLen * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-}
-
-Matrix::Matrix(int nRows, int nCols, double* data)
-{
-  RowCount = nRows;
-  ColumnCount = nCols;
-  DataLen = nRows * nCols;
-  Data = (double*)_aligned_malloc(DataLen * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-  memcpy(Data, data, DataLen * sizeof(double));
-}
-
-Matrix::Matrix(const Matrix &m)
-{
-  RowCount = m.RowCount;
-  ColumnCount = m.ColumnCount;
-  DataLen = RowCount * ColumnCount;
-  Data = (double*)_aligned_malloc(DataLen * sizeof(double), 64);
-  if (Data == NULL)
-    throw std::bad_alloc();
-  memcpy(Data, m.Data, DataLen * sizeof(double));
-}
-
-void Matrix::Zero()
-{
-  memset(Data, 0, DataLen * sizeof(double));
-}
-
-Matrix::~Matrix()
-{
-  if (Data != NULL)
-    _aligned_free(Data);
-}
+#include "stdafx.h"
+#include "LinReg.h"
+#include "QuqeMath.h"
+#include <exception>
+
+QM_THREAD_LOCAL int ThreadAllocationCount = 0;
+QM_THREAD_LOCAL long long ThreadAllocatedBytes = 0;
+
+QUQEMATH_API int GetThreadAllocationCount()
+{
+  return ThreadAllocationCount;
+}
+
+template <typename T>
+static T* AlignedAlloc(int count)
+{
+  T* data = (T*)_aligned_malloc(count * sizeof(T), 64);
+  if (data == NULL)
+    throw std::bad_alloc();
+  ThreadAllocationCount++;
+  ThreadAllocatedBytes += count * sizeof(T);
+  return data;
+}
+
+template <typename T>
+VectorT<T>::VectorT(int count)
+{
+  Count = count;
+  Data = AlignedAlloc<T>(count);
+  OwnsData = true;
+}
+
+template <typename T>
+VectorT<T>::VectorT(int count, T* data)
+{
+  Count = count;
+  Data = AlignedAlloc<T>(count);
+  OwnsData = true;
+  memcpy(Data, data, count * sizeof(T));
+}
+
+template <typename T>
+VectorT<T>::VectorT(const VectorT &v)
+{
+  Count = v.Count;
+  Data = AlignedAlloc<T>(Count);
+  OwnsData = true;
+  memcpy(Data, v.Data, Count * sizeof(T));
+}
+
+template <typename T>
+VectorT<T>* VectorT<T>::View(int count, T* data)
+{
+  VectorT* v = new VectorT();
+  v->Count = count;
+  v->Data = data;
+  v->OwnsData = false;
+  return v;
+}
+
+template <typename T>
+void VectorT<T>::Set(VectorT* v)
+{
+  BlasCopy(v->Count, v->Data, 1, Data, 1);
+}
+
+template <typename T>
+void VectorT<T>::Set(T* data, int stride, int count)
+{
+  BlasCopy(count, data, stride, Data, 1);
+}
+
+template <typename T>
+void VectorT<T>::Zero()
+{
+  memset(Data, 0, Count * sizeof(T));
+}
+
+template <typename T>
+VectorT<T>::~VectorT()
+{
+  if (Data != NULL && OwnsData)
+    _aligned_free(Data);
+}
+
+template <typename T>
+MatrixT<T>::MatrixT(int nRows, int nCols)
+{
+  RowCount = nRows;
+  ColumnCount = nCols;
+  DataLen = nRows * nCols;
+  Data = AlignedAlloc<T>(DataLen);
+  OwnsData = true;
+}
+
+template <typename T>
+MatrixT<T>::MatrixT(int nRows, int nCols, T* data)
+{
+  RowCount = nRows;
+  ColumnCount = nCols;
+  DataLen = nRows * nCols;
+  Data = AlignedAlloc<T>(DataLen);
+  OwnsData = true;
+  memcpy(Data, data, DataLen * sizeof(T));
+}
+
+template <typename T>
+MatrixT<T>::MatrixT(const MatrixT &m)
+{
+  RowCount = m.RowCount;
+  ColumnCount = m.ColumnCount;
+  DataLen = RowCount * ColumnCount;
+  Data = AlignedAlloc<T>(DataLen);
+  OwnsData = true;
+  memcpy(Data, m.Data, DataLen * sizeof(T));
+}
+
+template <typename T>
+MatrixT<T>* MatrixT<T>::View(int nRows, int nCols, T* data)
+{
+  MatrixT* m = new MatrixT();
+  m->RowCount = nRows;
+  m->ColumnCount = nCols;
+  m->DataLen = nRows * nCols;
+  m->Data = data;
+  m->OwnsData = false;
+  return m;
+}
+
+template <typename T>
+void MatrixT<T>::Zero()
+{
+  memset(Data, 0, DataLen * sizeof(T));
+}
+
+template <typename T>
+MatrixT<T>::~MatrixT()
+{
+  if (Data != NULL && OwnsData)
+    _aligned_free(Data);
+}
+
+template class VectorT<double>;
+template class VectorT<float>;
+template class MatrixT<double>;
+template class MatrixT<float>;
@@ -1,72 +1,154 @@
-#ifndef LINREG_H
-#define LINREG_H
-
-typedef int blasint; // hack for cblas.h
-#define _Complex // hack for cblas.h
-#include "cblas.h"
-
-class Vector
-{
-public:
-  int Count;
-  double* Data;
-
-  Vector(const Vector &v);
-  Vector(int count);
-  Vector(int count, double* data);
-  void Vector::Set(Vector* v);
-  void Vector::Set(double* data, int stride, int count);
-  void Zero();
-  ~Vector();
-};
-
-class Matrix
-{
-public:
-  int RowCount;
-  int ColumnCount;
-  double* Data;
-  int DataLen;
-  
-  Matrix(const Matrix &m);
-  Matrix(int nRows, int nCols);
-  Matrix(int nRows, int nCols, double* data);
-  void Zero();
-  ~Matrix();
-};
-
-#define GetRowPtr(m,i)    ((m)->Data + (i) * (m)->ColumnCount)
-
-#define GetColumnPtr(m,j)    ((m)->Data + (j))
-
-inline void GEMV(double alpha, Matrix* a, Vector* x, double beta, Vector* y)
-{
-  int columnCount = a->ColumnCount;
-  cblas_dgemv(CblasRowMajor, CblasNoTrans, a->RowCount, columnCount,
-    alpha, a->Data, columnCount, x->Data, 1, beta, y->Data, 1);
-}
-
-inline void GEMV(double alpha, Matrix* a, double* x, int xStride, double beta, Vector* y)
-{
-  int columnCount = a->ColumnCount;
-  cblas_dgemv(CblasRowMajor, CblasNoTrans, a->RowCount, columnCount,
-    alpha, a->Data, columnCount, x, xStride, beta, y->Data, 1);
-}
-
-inline void GER(double alpha, double* x, double* y, Matrix* a)
-{
-  int columnCount = a->ColumnCount;
-  cblas_dger(CblasRowMajor, a->RowCount, columnCount, alpha, x, 1, y, 1, a->Data, columnCount);
-}
-
-inline double Dot(Vector* a, Vector* b)
-{
-  return cblas_ddot(a->Count, a->Data, 1, b->Data, 1);
-}
-
-#define DotColumn(a,column,b)   (cblas_ddot((b)->Count, (a)->Data + (column), (a)->ColumnCount, (b)->Data, 1))
-
-#define AXPY(alpha,x,n,y)    (cblas_daxpy((n), (alpha), (x)->Data, 1, (y), 1))
-#define AXPY2(alpha,xData,n,y)    (cblas_daxpy((n), (alpha), (xData), 1, (y), 1))
-
+#ifndef LINREG_H
+#define LINREG_H
+
+#include <string.h>
+#include "Platform.h"
+
+typedef int blasint; // hack for cblas.h
+#define _Complex // hack for cblas.h
+#include "cblas.h"
+
+// number and total size of Vector/Matrix buffers allocated by the calling thread
+extern QM_THREAD_LOCAL int ThreadAllocationCount;
+extern QM_THREAD_LOCAL long long ThreadAllocatedBytes;
+
+// Vector and Matrix are templated on the scalar type so the training code can run in float as well as
+// double. Member functions are instantiated for float and double in LinReg.cpp. A view (from View) points at
+// memory someone else owns and keeps alive; deleting it leaves the memory alone. Copies of views own their data
+template <typename T>
+class VectorT
+{
+public:
+  int Count;
+  T* Data;
+  bool OwnsData;
+
+  VectorT(const VectorT &v);
+  VectorT(int count);
+  VectorT(int count, T* data);
+  static VectorT* View(int count, T* data);
+  void Set(VectorT* v);
+  void Set(T* data, int stride, int count);
+  void Zero();
+  ~VectorT();
+
+private:
+  VectorT() {}
+};
+
+template <typename T>
+class MatrixT
+{
+public:
+  int RowCount;
+  int ColumnCount;
+  T* Data;
+  int DataLen;
+  bool OwnsData;
+  
+  MatrixT(const MatrixT &m);
+  MatrixT(int nRows, int nCols);
+  MatrixT(int nRows, int nCols, T* data);
+  static MatrixT* View(int nRows, int nCols, T* data);
+  void Zero();
+  ~MatrixT();
+
+private:
+  MatrixT() {}
+};
+
+typedef VectorT<double> Vector;
+typedef MatrixT<double> Matrix;
+
+// converting copy, for moving data between double and float buffers
+template <typename TDest, typename TSrc>
+inline void ConvertCopy(TDest* dest, const TSrc* src, int count)
+{
+  for (int i = 0; i < count; i++)
+    dest[i] = (TDest)src[i];
+}
+
+template <>
+inline void ConvertCopy(double* dest, const double* src, int count)
+{
+  memcpy(dest, src, count * sizeof(double));
+}
+
+// the CBLAS routines used by templated code, overloaded on scalar type. All row-major
+inline void BlasCopy(int n, double* x, int incx, double* y, int incy) { cblas_dcopy(n, x, incx, y, incy); }
+inline void BlasCopy(int n, float* x, int incx, float* y, int incy) { cblas_scopy(n, x, incx, y, incy); }
+
+inline void BlasGemv(enum CBLAS_TRANSPOSE trans, int m, int n, double alpha, double* a, int lda, double* x, int incx,
+  double beta, double* y, int incy)
+{
+  cblas_dgemv(CblasRowMajor, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+inline void BlasGemv(enum CBLAS_TRANSPOSE trans, int m, int n, float alpha, float* a, int lda, float* x, int incx,
+  float beta, float* y, int incy)
+{
+  cblas_sgemv(CblasRowMajor, trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+inline void BlasGemm(enum CBLAS_TRANSPOSE transA, enum CBLAS_TRANSPOSE transB, int m, int n, int k,
+  double alpha, double* a, int lda, double* b, int ldb, double beta, double* c, int ldc)
+{
+  cblas_dgemm(CblasRowMajor, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+inline void BlasGemm(enum CBLAS_TRANSPOSE transA, enum CBLAS_TRANSPOSE transB, int m, int n, int k,
+  float alpha, float* a, int lda, float* b, int ldb, float beta, float* c, int ldc)
+{
+  cblas_sgemm(CblasRowMajor, transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+#define GetRowPtr(m,i)    ((m)->Data + (i) * (m)->ColumnCount)
+
+#define GetColumnPtr(m,j)    ((m)->Data + (j))
+
+template <typename T>
+inline void GEMV(double alpha, MatrixT<T>* a, VectorT<T>* x, double beta, VectorT<T>* y)
+{
+  int columnCount = a->ColumnCount;
+  BlasGemv(CblasNoTrans, a->RowCount, columnCount, (T)alpha, a->Data, columnCount, x->Data, 1, (T)beta, y->Data, 1);
+}
+
+template <typename T>
+inline void GEMV(double alpha, MatrixT<T>* a, T* x, int xStride, double beta, VectorT<T>* y)
+{
+  int columnCount = a->ColumnCount;
+  BlasGemv(CblasNoTrans, a->RowCount, columnCount, (T)alpha, a->Data, columnCount, x, xStride, (T)beta, y->Data, 1);
+}
+
+template <typename T>
+inline void GEMV(double alpha, MatrixT<T>* a, T* x, int xStride, double beta, T* y)
+{
+  int columnCount = a->ColumnCount;
+  BlasGemv(CblasNoTrans, a->RowCount, columnCount, (T)alpha, a->Data, columnCount, x, xStride, (T)beta, y, 1);
+}
+
+// y = alpha * a' * x + beta * y
+template <typename T>
+inline void GEMVT(double alpha, MatrixT<T>* a, T* x, double beta, T* y)
+{
+  int columnCount = a->ColumnCount;
+  BlasGemv(CblasTrans, a->RowCount, columnCount, (T)alpha, a->Data, columnCount, x, 1, (T)beta, y, 1);
+}
+
+inline void GER(double alpha, double* x, double* y, Matrix* a)
+{
+  int columnCount = a->ColumnCount;
+  cblas_dger(CblasRowMajor, a->RowCount, columnCount, alpha, x, 1, y, 1, a->Data, columnCount);
+}
+
+inline double Dot(Vector* a, Vector* b)
+{
+  return cblas_ddot(a->Count, a->Data, 1, b->Data, 1);
+}
+
+#define DotColumn(a,column,b)   (cblas_ddot((b)->Count, (a)->Data + (column), (a)->ColumnCount, (b)->Data, 1))
+
+#define AXPY(alpha,x,n,y)    (cblas_daxpy((n), (alpha), (x)->Data, 1, (y), 1))
+#define AXPY2(alpha,xData,n,y)    (cblas_daxpy((n), (alpha), (xData), 1, (y), 1))
+
 #endif
\ No newline at end of file
@@ -0,0 +1,170 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include <limits>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+// Orthogonal least squares selection of RBF centers (Chen, Cowan & Grant 1991). Each candidate keeps its
+// residual against the bases chosen so far. Choosing a basis costs one rank-1 update of all residuals
+// instead of re-orthogonalizing every candidate against every chosen basis.
+
+// candidates whose residual has shrunk below this fraction of their original norm are in the span of the
+// chosen bases, to rounding error, and are skipped
+static const double NegligibleResidual = 1e-10;
+
+// Residual norms are downdated after each rank-1 update rather than recomputed. Once a candidate's has lost
+// this fraction of its original value, cancellation has eaten most of its digits, so it is recomputed instead
+static const double DowndateRecompute = 1e-4;
+
+// Least squares fit of y by a bias plus the selected candidates, by Householder QR so the conditioning isn't
+// squared as it would be through the normal equations. weights[0] is the bias. All weights are NaN if the
+// selected bases are linearly dependent to working precision
+static void SolveWeights(double* candidates, int n, double* y, int* selected, int numSelected, double* weights)
+{
+	int nw = numSelected + 1;
+	Matrix* h = new Matrix(nw, n); // the design matrix transposed, so each basis is a contiguous row
+	for (int i = 0; i < n; i++)
+		h->Data[i] = 1;
+	for (int s = 0; s < numSelected; s++)
+		memcpy(GetRowPtr(h, s + 1), candidates + selected[s] * n, n * sizeof(double));
+	Vector* b = new Vector(n, y);
+	Vector* diag = new Vector(nw);
+
+	// reduce h to upper triangular R, applying the same reflections to b. Column j of R lives in row j of h
+	bool singular = nw > n;
+	double maxDiag = 0;
+	for (int j = 0; j < nw && !singular; j++)
+	{
+		double* v = GetRowPtr(h, j) + j;
+		int len = n - j;
+		double norm = cblas_dnrm2(len, v, 1);
+		double alpha = v[0] > 0 ? -norm : norm;
+		diag->Data[j] = alpha;
+		if (fabs(alpha) > maxDiag)
+			maxDiag = fabs(alpha);
+		if (!(fabs(alpha) > n * DBL_EPSILON * maxDiag))
+		{
+			singular = true;
+			break;
+		}
+		v[0] -= alpha;
+		double vv = cblas_ddot(len, v, 1, v, 1);
+		for (int k = j + 1; k < nw; k++)
+		{
+			double* hk = GetRowPtr(h, k) + j;
+			cblas_daxpy(len, -2 * cblas_ddot(len, v, 1, hk, 1) / vv, v, 1, hk, 1);
+		}
+		cblas_daxpy(len, -2 * cblas_ddot(len, v, 1, b->Data + j, 1) / vv, v, 1, b->Data + j, 1);
+	}
+
+	if (singular)
+	{
+		for (int i = 0; i < nw; i++)
+			weights[i] = std::numeric_limits<double>::quiet_NaN();
+	}
+	else
+	{
+		for (int j = nw - 1; j >= 0; j--)
+		{
+			double s = b->Data[j];
+			for (int k = j + 1; k < nw; k++)
+				s -= GetRowPtr(h, k)[j] * weights[k];
+			weights[j] = s / diag->Data[j];
+		}
+	}
+	delete h;
+	delete b;
+	delete diag;
+}
+
+// candidates holds m candidate basis vectors of length n, one after another. Chooses up to maxBases of them,
+// each time taking the candidate whose orthogonalized residual explains most of what is left of y (the error
+// reduction ratio), until the chosen bases explain all but tolerance of y's variance. Writes the chosen
+// candidates' indices to selected and the least squares weights (bias first, numSelected + 1 of them) to
+// weights, and returns the number chosen. Stops early when *cancelFlag becomes nonzero
+QUQEMATH_API int SelectOLSBases(double* candidates, int n, int m, double* y, double tolerance, int maxBases,
+	volatile int* cancelFlag, int* selected, double* weights)
+{
+	Matrix* r = new Matrix(m, n, candidates); // residuals, one candidate per row
+	Vector* d = new Vector(n); // y with its mean removed, normalized
+	Vector* q = new Vector(n); // the basis just chosen, normalized
+	Vector* projections = new Vector(m);
+	Vector* norm2 = new Vector(m); // squared norm of each residual
+	Vector* initialNorm2 = new Vector(m);
+	Vector* quality = new Vector(m);
+	bool* used = new bool[m];
+
+	double mean = 0;
+	for (int i = 0; i < n; i++)
+		mean += y[i];
+	mean /= n;
+	for (int i = 0; i < n; i++)
+		d->Data[i] = y[i] - mean;
+	cblas_dscal(n, 1 / cblas_dnrm2(n, d->Data, 1), d->Data, 1);
+
+	for (int j = 0; j < m; j++)
+	{
+		double* rj = GetRowPtr(r, j);
+		initialNorm2->Data[j] = cblas_ddot(n, rj, 1, rj, 1);
+		norm2->Data[j] = initialNorm2->Data[j];
+		used[j] = false;
+	}
+
+	int numSelected = 0;
+	double qualityTotal = 0;
+	while (numSelected < maxBases)
+	{
+		// error reduction ratio of each candidate is (r.d)^2 / (r.r), or 0 for those that can't be chosen. The
+		// loop is branch free so it vectorizes, and the ratios are never negative, so idamax finds the largest
+		GEMV(1, r, d, 0, projections);
+		double* p = projections->Data;
+		double* rr = norm2->Data;
+		double* q0 = initialNorm2->Data;
+		double* qual = quality->Data;
+		for (int j = 0; j < m; j++)
+		{
+			bool eligible = !used[j] & (rr[j] > NegligibleResidual * NegligibleResidual * q0[j]);
+			qual[j] = eligible ? p[j] * p[j] / rr[j] : 0;
+		}
+		int best = (int)cblas_idamax(m, qual, 1);
+		double bestQuality = qual[best];
+		// nothing left that would reduce the error
+		if (!(bestQuality > 0))
+			break;
+
+		used[best] = true;
+		selected[numSelected++] = best;
+		qualityTotal += bestQuality;
+		if (1 - qualityTotal < tolerance || (cancelFlag != NULL && *cancelFlag))
+			break;
+
+		// remove the new basis from every residual: r_j -= (r_j.q) q
+		double* rb = GetRowPtr(r, best);
+		double norm = cblas_dnrm2(n, rb, 1);
+		for (int i = 0; i < n; i++)
+			q->Data[i] = rb[i] / norm;
+		GEMV(1, r, q, 0, projections);
+		GER(-1, projections->Data, q->Data, r);
+		for (int j = 0; j < m; j++)
+		{
+			norm2->Data[j] -= projections->Data[j] * projections->Data[j];
+			if (norm2->Data[j] < DowndateRecompute * initialNorm2->Data[j])
+			{
+				double* rj = GetRowPtr(r, j);
+				norm2->Data[j] = cblas_ddot(n, rj, 1, rj, 1);
+			}
+		}
+	}
+
+	SolveWeights(candidates, n, y, selected, numSelected, weights);
+
+	delete r;
+	delete d;
+	delete q;
+	delete projections;
+	delete norm2;
+	delete initialNorm2;
+	delete quality;
+	delete [] used;
+	return numSelected;
+}
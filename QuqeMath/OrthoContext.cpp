@@ -1,44 +1,77 @@
-#include "stdafx.h"
-#include <stdio.h>
-#include "QuqeMath.h"
-#include "LinReg.h"
-
-OrthoContext::OrthoContext(int basisDimension, int maxBasisCount)
-{
-	Pv = new Vector(basisDimension);
-	Bases = new Matrix(maxBasisCount, basisDimension);
-	Dp = new Vector(maxBasisCount);
-}
-
-OrthoContext::~OrthoContext()
-{
-	delete Pv;
-	delete Bases;
-	delete Dp;
-}
-
-QUQEMATH_API void* CreateOrthoContext(int basisDimension, int maxBasisCount)
-{
-	return new OrthoContext(basisDimension, maxBasisCount);
-}
-
-QUQEMATH_API void DestroyOrthoContext(void* context)
-{
-	delete ((OrthoContext*)context);
-}
-
-void Orthogonalize(OrthoContext* c, double* p, int numBases, double* orthonormalBases)
-{
-	memcpy(c->Pv->Data, p, c->Pv->Count * sizeof(double));
-	memcpy(c->Bases->Data, orthonormalBases, numBases * c->Pv->Count * sizeof(double));
-	c->Bases->RowCount = numBases;
-	c->Dp->Count = numBases;
-
-	int basisLen = c->Pv->Count;
-	GEMV(1, c->Bases, c->Pv, 0, c->Dp);
-	for (int i = 0, offset = 0; i < numBases; i++, offset += basisLen)
-		AXPY2(-1 * c->Dp->Data[i], c->Bases->Data + offset, basisLen, c->Pv->Data);
-	double mag = cblas_dnrm2(basisLen, c->Pv->Data, 1);
-	cblas_dscal(basisLen, 1.0 / mag, c->Pv->Data, 1);
-	memcpy(p, c->Pv->Data, basisLen * sizeof(double));
-}
\ No newline at end of file
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+OrthoContext::OrthoContext(int basisDimension, int maxBasisCount)
+{
+	BasisDimension = basisDimension;
+	MaxBasisCount = maxBasisCount;
+	Bases = new Matrix(maxBasisCount, basisDimension);
+	Bases->RowCount = 0;
+	Projections = new Matrix(maxBasisCount, OrthoBlockSize);
+}
+
+OrthoContext::~OrthoContext()
+{
+	delete Bases;
+	delete Projections;
+}
+
+QUQEMATH_API void* CreateOrthoContext(int basisDimension, int maxBasisCount)
+{
+	return new OrthoContext(basisDimension, maxBasisCount);
+}
+
+QUQEMATH_API void DestroyOrthoContext(void* context)
+{
+	delete ((OrthoContext*)context);
+}
+
+QUQEMATH_API int AppendBasis(OrthoContext* c, double* basis)
+{
+	assert(c->Bases->RowCount < c->MaxBasisCount);
+	memcpy(GetRowPtr(c->Bases, c->Bases->RowCount), basis, c->BasisDimension * sizeof(double));
+	return ++c->Bases->RowCount;
+}
+
+QUQEMATH_API int GetBasisCount(OrthoContext* c)
+{
+	return c->Bases->RowCount;
+}
+
+QUQEMATH_API void ClearBases(OrthoContext* c)
+{
+	c->Bases->RowCount = 0;
+}
+
+// classical Gram-Schmidt against all bases at once: with the candidates as the rows of P,
+// P -= (P B') B, then each row is normalized
+QUQEMATH_API void OrthogonalizeMany(OrthoContext* c, double* candidates, int count)
+{
+	int dim = c->BasisDimension;
+	int numBases = c->Bases->RowCount;
+	for (int first = 0; first < count; first += OrthoBlockSize)
+	{
+		int blockSize = count - first < OrthoBlockSize ? count - first : OrthoBlockSize;
+		double* block = candidates + first * dim;
+		if (numBases > 0)
+		{
+			BlasGemm(CblasNoTrans, CblasTrans, numBases, blockSize, dim,
+				1.0, c->Bases->Data, dim, block, dim, 0.0, c->Projections->Data, OrthoBlockSize);
+			BlasGemm(CblasTrans, CblasNoTrans, blockSize, dim, numBases,
+				-1.0, c->Projections->Data, OrthoBlockSize, c->Bases->Data, dim, 1.0, block, dim);
+		}
+		for (int i = 0; i < blockSize; i++)
+		{
+			double* p = block + i * dim;
+			double mag = cblas_dnrm2(dim, p, 1);
+			cblas_dscal(dim, 1.0 / mag, p, 1);
+		}
+	}
+}
+
+QUQEMATH_API void Orthogonalize(OrthoContext* c, double* p)
+{
+	OrthogonalizeMany(c, p, 1);
+}
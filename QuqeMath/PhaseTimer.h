@@ -0,0 +1,41 @@
+#ifndef PHASETIMER_H
+#define PHASETIMER_H
+
+// include after QuqeMath.h, which has no include guard
+
+#if QUQEMATH_STATS
+
+#include <chrono>
+
+// Adds the time between its construction and destruction to one phase of a context's stats
+class PhaseTimer
+{
+public:
+  PhaseTimer(ContextStats* stats, int phase, double flops)
+  {
+    Phase = &stats->Phases[phase];
+    Phase->Calls++;
+    Phase->Flops += flops;
+    Start = std::chrono::steady_clock::now();
+  }
+
+  ~PhaseTimer()
+  {
+    Phase->Nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - Start).count();
+  }
+
+private:
+  PhaseStats* Phase;
+  std::chrono::steady_clock::time_point Start;
+};
+
+// times the rest of the enclosing block
+#define TIME_PHASE(stats, phase, flops) PhaseTimer phaseTimer((stats), (phase), (flops))
+
+#else
+
+#define TIME_PHASE(stats, phase, flops)
+
+#endif
+
+#endif
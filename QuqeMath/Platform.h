@@ -0,0 +1,34 @@
+#ifndef PLATFORM_H
+#define PLATFORM_H
+
+// Stand-ins for the MSVC-specific pieces the rest of QuqeMath uses, so it also builds with GCC and Clang
+
+#if defined(_MSC_VER)
+
+#define QM_THREAD_LOCAL __declspec(thread)
+
+#else
+
+#include <stdlib.h>
+#include <math.h>
+
+#define QM_THREAD_LOCAL __thread
+
+inline void* _aligned_malloc(size_t size, size_t alignment)
+{
+  void* p = NULL;
+  if (posix_memalign(&p, alignment, size > 0 ? size : alignment) != 0)
+    return NULL;
+  return p;
+}
+
+inline void _aligned_free(void* p)
+{
+  free(p);
+}
+
+#define _isnan(x) isnan(x)
+
+#endif
+
+#endif
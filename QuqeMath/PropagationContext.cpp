@@ -1,21 +1,74 @@
-#include "stdafx.h"
-#include <stdio.h>
-#include "QuqeMath.h"
-#include "LinReg.h"
-
-QUQEMATH_API void* CreatePropagationContext(LayerSpec* layerSpecs, int nLayers, int nInputs, double* weights, int nWeights)
-{
-	Layer** protoLayers = SpecsToLayers(nInputs, layerSpecs, nLayers);
-	Frame** frames = LayersToFrames(protoLayers, nLayers, 1);
-	Frame* theFrame = frames[0];
-
-	SetWeights(theFrame->Layers, nLayers, weights, nWeights);
-	DeleteLayers(protoLayers, nLayers, false);
-	return frames;
-}
-
-QUQEMATH_API void DestroyPropagationContext(void* context)
-{
-	DeleteFrames((Frame**)context, 1);
-}
-
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+PropagationContext::PropagationContext(LayerSpec* specs, int nLayers, int nInputs, double* weights, int nWeights)
+{
+	NumInputs = nInputs;
+	NumLayers = nLayers;
+	Layers = SpecsToLayers<double>(nInputs, specs, nLayers);
+	SetWeights(Layers, nLayers, weights, nWeights);
+}
+
+// the recurrent state is the z of each recurrent layer, in layer order. The other layers' z is
+// overwritten before it is read on every step, so it needn't be saved
+int PropagationContext::StateSize()
+{
+	int size = 0;
+	for (int l = 0; l < NumLayers; l++)
+		if (Layers[l]->IsRecurrent)
+			size += Layers[l]->NodeCount;
+	return size;
+}
+
+PropagationContext::~PropagationContext()
+{
+	DeleteLayers(Layers, NumLayers, true);
+}
+
+QUQEMATH_API void* CreatePropagationContext(LayerSpec* layerSpecs, int nLayers, int nInputs, double* weights, int nWeights)
+{
+	return new PropagationContext(layerSpecs, nLayers, nInputs, weights, nWeights);
+}
+
+QUQEMATH_API void DestroyPropagationContext(void* context)
+{
+	delete ((PropagationContext*)context);
+}
+
+QUQEMATH_API int GetStateSize(PropagationContext* c)
+{
+	return c->StateSize();
+}
+
+QUQEMATH_API void SaveState(PropagationContext* c, double* state)
+{
+	for (int l = 0; l < c->NumLayers; l++)
+	{
+		Layer* layer = c->Layers[l];
+		if (!layer->IsRecurrent)
+			continue;
+		memcpy(state, layer->z->Data, layer->NodeCount * sizeof(double));
+		state += layer->NodeCount;
+	}
+}
+
+QUQEMATH_API void RestoreState(PropagationContext* c, double* state)
+{
+	for (int l = 0; l < c->NumLayers; l++)
+	{
+		Layer* layer = c->Layers[l];
+		if (!layer->IsRecurrent)
+			continue;
+		memcpy(layer->z->Data, state, layer->NodeCount * sizeof(double));
+		state += layer->NodeCount;
+	}
+}
+
+// puts the context back in the state it was created in
+QUQEMATH_API void ResetState(PropagationContext* c)
+{
+	for (int l = 0; l < c->NumLayers; l++)
+		c->Layers[l]->z->Zero();
+}
@@ -1,251 +1,655 @@
-#include "stdafx.h"
-#include <stdio.h>
-#include <float.h>
-#include "QuqeMath.h"
-#include "LinReg.h"
-
-QUQEMATH_API void EvaluateWeights(TrainingContext* c, double* weights, int nWeights, double* output, double* error, double* gradient)
-{
-	int netNumInputs = c->Frames[0]->Layers[0]->W->ColumnCount;
-	int t_max = c->TrainingInput->ColumnCount - 1;
-	Frame** time = c->Frames;
-	double totalOutputError = 0;
-
-	Matrix* trainingInput = c->TrainingInput;
-	Vector* trainingOutput = c->TrainingOutput;
-	int numLayers = c->NumLayers;
-
-	// propagate inputs forward
-	SetWeights(time[0]->Layers, numLayers, weights, nWeights); // time[0] is sufficient since all share the same weight matrices/vectors
-	for (int t = 0; t <= t_max; t++)
-	{
-		Propagate(GetColumnPtr(trainingInput, t), trainingInput->ColumnCount, numLayers,
-			time[t]->Layers, t > 0 ? time[t-1]->Layers : NULL);
-	}
-	Layer* lastLayer = time[t_max]->Layers[numLayers-1];
-	memcpy(output, lastLayer->z->Data, lastLayer->NodeCount * sizeof(double));
-
-	// propagate error backward
-	for (int t = t_max; t >= 0; t--)
-	{
-		int l_max = numLayers - 1;
-		for (int l = l_max; l >= 0; l--)
-		{
-			Layer* layer = time[t]->Layers[l];
-			for (int i = 0; i < layer->NodeCount; i++)
-			{
-				double err;
-
-				// calculate error propagated to next layer
-				if (l == l_max)
-				{
-					err = (trainingOutput->Data[t] - layer->z->Data[i]);
-					totalOutputError += 0.5 * pow(err, 2);
-				}
-				else
-				{
-					Layer* subsequentLayer = time[t]->Layers[l + 1];
-					Matrix* w = subsequentLayer->W;
-					Vector* d = subsequentLayer->d;
-					err = DotColumn(w, i, d);
-				}
-
-				// calculate error propagated forward in time (recurrently)
-				if (t < t_max && layer->IsRecurrent)
-				{
-					Layer* nextLayerInTime = time[t + 1]->Layers[l];
-					Matrix* wr = nextLayerInTime->Wr;
-					Vector* d = nextLayerInTime->d;
-					err += DotColumn(wr, i, d);
-				}
-
-				if (layer->ActivationType == ACTIVATION_LOGSIG)
-					layer->d->Data[i] = err * LogisticSigmoidPrime(layer->a->Data[i]);
-				else // ACTIVATION_PURELIN
-					layer->d->Data[i] = err;
-			}
-		}
-	}
-	*error = totalOutputError;
-
-	// calculate gradient
-	Layer** gradLayers = SpecsToLayers(netNumInputs, c->LayerSpecs, numLayers);
-	for (int t = 0; t <= t_max; t++)
-	{
-		for (int l = 0; l < numLayers; l++)
-		{
-			int nodeCount = gradLayers[l]->NodeCount;
-			int inputCount = gradLayers[l]->InputCount;
-
-			// W
-			Layer* layertl = time[t]->Layers[l];
-			GER(-1.0, layertl->d->Data, layertl->x->Data, gradLayers[l]->W);
-
-			// Wr
-			if (t > 0 && gradLayers[l]->IsRecurrent)
-			{
-				Layer* layert1l = time[t - 1]->Layers[l];
-				GER(-1.0, layertl->d->Data, layert1l->z->Data, gradLayers[l]->Wr);
-			}
-
-			// Bias
-			Vector* layertld = layertl->d;
-			AXPY(-1.0, layertld, layertld->Count, gradLayers[l]->Bias->Data);
-		}
-	}
-	GetWeights(gradLayers, numLayers, gradient, nWeights);
-	for (int l = 0; l < numLayers; l++)
-	{
-		Layer* layer = gradLayers[l];
-		layer->DeleteWeights();
-		delete layer;
-	}
-	delete [] gradLayers;
-}
-
-QUQEMATH_API void PropagateInput(Frame** frames, double* input, double* output)
-{
-	Frame* theFrame = frames[0];
-	Propagate(input, 1, theFrame->NumLayers, theFrame->Layers, theFrame->Layers);
-	Layer* lastLayer = theFrame->Layers[theFrame->NumLayers-1];
-	memcpy(output, lastLayer->z->Data, lastLayer->NodeCount * sizeof(double));
-}
-
-void Propagate(double* input, int inputStride, int numLayers, Layer** currLayers, Layer** prevLayers)
-{
-	Layer* layer0 = currLayers[0];
-	PropagateLayer(input, inputStride, layer0, prevLayers != NULL ? prevLayers[0]->z : NULL);
-	input = layer0->z->Data;
-	for (int l = 1; l < numLayers; l++)
-	{
-		Layer* layer = currLayers[l];
-		PropagateLayer(input, 1, layer, prevLayers != NULL ? prevLayers[l]->z : NULL);
-		input = layer->z->Data;
-	}
-}
-
-void AssertNoNaNs(double* xs, int count)
-{
-	for (int i=0; i<count; i++)
-		assert(!_isnan(xs[i]));
-}
-
-void PropagateLayer(double* input, int inputStride, Layer* layer, Vector* recurrentInput)
-{
-	int inputCount = layer->InputCount;
-	
-#if DEBUG
-	AssertNoNaNs(input, inputCount);
-	if (recurrentInput != NULL)
-		AssertNoNaNs(recurrentInput->Data, recurrentInput->Count);
-#endif
-
-	// set x
-	layer->x->Set(input, inputStride, inputCount);
-
-	// compute a
-	layer->a->Set(layer->Bias);
-	GEMV(1, layer->W, input, inputStride, 1, layer->a);
-	if (layer->IsRecurrent)
-	{
-		Vector* ri = recurrentInput != NULL ? recurrentInput : MakeTimeZeroRecurrentInput(layer->NodeCount);
-		GEMV(1, layer->Wr, ri, 1, layer->a);
-		if (recurrentInput == NULL)
-			delete ri;
-	}
-
-	// compute z
-	layer->z->Set(layer->a);
-	if (layer->ActivationType == ACTIVATION_LOGSIG)
-	{
-		int len = layer->z->Count;
-		double* zData = layer->z->Data;
-		for (int i = 0; i < len; i++)
-			zData[i] = LogisticSigmoid(zData[i]);
-	}
-	// else ACTIVATION_PURELIN, in which case zData is already what it should be
-
-#if DEBUG
-	AssertNoNaNs(layer->z->Data, layer->z->Count);
-#endif
-}
-
-void SetWeights(Layer** layers, int numLayers, double* weights, int nWeights)
-{
-	double* dp = weights;
-	for (int layer = 0; layer < numLayers; layer++)
-	{
-		Layer* l = layers[layer];
-		dp = SetMatrixWeights(l->W, dp);
-		if (l->IsRecurrent)
-			dp = SetMatrixWeights(l->Wr, dp);
-		dp = SetVectorWeights(l->Bias, dp);
-	}
-	assert(weights + nWeights == dp);
-}
-
-double* SetVectorWeights(Vector* v, double* weights)
-{
-	int len = v->Count;
-	memcpy(v->Data, weights, len * sizeof(double));
-	return weights + len;
-}
-
-double* SetMatrixWeights(Matrix* m, double* weights)
-{
-	int len = m->RowCount * m->ColumnCount;
-	memcpy(m->Data, weights, len * sizeof(double));
-	return weights + len;
-}
-
-double* BigNonThreadsafeTempArray = new double[1024*1024];
-int GetWeightCount(LayerSpec* layerSpecs, int nLayers, int nInputs)
-{
-	Layer** layers = SpecsToLayers(nInputs, layerSpecs, nLayers);
-	int nWeights = GetWeights(layers, nLayers, BigNonThreadsafeTempArray, -1);
-	DeleteLayers(layers, nLayers, true);
-	return nWeights;
-}
-
-int GetWeights(Layer** layers, int numLayers, double* weights, int nWeights)
-{
-	double* dp = weights;
-	for (int layer = 0; layer < numLayers; layer++)
-	{
-		Layer* l = layers[layer];
-		dp = GetMatrixWeights(l->W, dp);
-		if (l->IsRecurrent)
-			dp = GetMatrixWeights(l->Wr, dp);
-		dp = GetVectorWeights(l->Bias, dp);
-	}
-	if (nWeights != -1)
-	{
-		assert(weights + nWeights == dp);
-		assert(nWeights == (dp - weights));
-	}
-	int result = dp - weights;
-	return result;
-}
-
-double* GetVectorWeights(Vector* v, double* weights)
-{
-	int len = v->Count;
-	memcpy(weights, v->Data, len * sizeof(double));
-	return weights + len;
-}
-
-double* GetMatrixWeights(Matrix* m, double* weights)
-{
-	int len = m->RowCount * m->ColumnCount;
-	memcpy(weights, m->Data, len * sizeof(double));
-	return weights + len;
-}
-
-Vector* MakeTimeZeroRecurrentInput(int size)
-{
-	Vector* v = new Vector(size);
-	double* vData = v->Data;
-	for (int i = 0; i < size; i++)
-		vData[i] = TimeZeroRecurrentInputValue;
-	return v;
-}
+#include "stdafx.h"
+#include <stdio.h>
+#include <float.h>
+#include <limits>
+#include "QuqeMath.h"
+#include "LinReg.h"
+#include "PhaseTimer.h"
+
+// Writes the gradient contributed by slab rows [t0, t1) to g, one GEMM per weight matrix. inputs points at the
+// first layer's input for row t0. Row 0 has no previous row to take a recurrent input from. The flat layout
+// matches SetWeights: W, then Wr if recurrent, then Bias, for each layer
+template <typename T>
+static void ComputeGradient(TrainingBuffers<T>* b, int numLayers, int t0, int t1, T* inputs, T* g, int nWeights)
+{
+	int nt = t1 - t0;
+	T* gp = g;
+	for (int l = 0; l < numLayers; l++)
+	{
+		LayerT<T>* layer = b->Layers[l];
+		int nodeCount = layer->NodeCount;
+		int inputCount = layer->InputCount;
+		MatrixT<T>* d = b->D[l];
+		T* x = l == 0 ? inputs : GetRowPtr(b->Z[l-1], t0);
+
+		// W = -sum over t of d(t) x(t)'
+		BlasGemm(CblasTrans, CblasNoTrans, nodeCount, inputCount, nt,
+			-1, GetRowPtr(d, t0), nodeCount, x, inputCount, 0, gp, inputCount);
+		gp += nodeCount * inputCount;
+
+		// Wr = -sum over t > 0 of d(t) z(t-1)'
+		if (layer->IsRecurrent)
+		{
+			int tr0 = t0 > 0 ? t0 : 1;
+			if (t1 > tr0)
+				BlasGemm(CblasTrans, CblasNoTrans, nodeCount, nodeCount, t1 - tr0,
+					-1, GetRowPtr(d, tr0), nodeCount, GetRowPtr(b->Z[l], tr0 - 1), nodeCount, 0, gp, nodeCount);
+			else
+				memset(gp, 0, nodeCount * nodeCount * sizeof(T));
+			gp += nodeCount * nodeCount;
+		}
+
+		// Bias = -sum over t of d(t)
+		BlasGemv(CblasTrans, nt, nodeCount, -1, GetRowPtr(d, t0), nodeCount, b->Ones->Data, 1, 0, gp, 1);
+		gp += nodeCount;
+	}
+	assert(gp == g + nWeights);
+}
+
+static void AccumulateGradient(TrainingBuffers<double>* b, int numLayers, int numSamples, double* gradient, int nWeights)
+{
+	ComputeGradient(b, numLayers, 0, numSamples, b->Inputs, gradient, nWeights);
+}
+
+// each block is summed in float by sgemm, and the blocks are summed in double
+static void AccumulateGradient(TrainingBuffers<float>* b, int numLayers, int numSamples, double* gradient, int nWeights)
+{
+	float* block = b->GradientBlock->Data;
+	memset(gradient, 0, nWeights * sizeof(double));
+	for (int t0 = 0; t0 < numSamples; t0 += b->GradientBlockLength)
+	{
+		int t1 = t0 + b->GradientBlockLength < numSamples ? t0 + b->GradientBlockLength : numSamples;
+		ComputeGradient(b, numLayers, t0, t1, b->GetInputRow(t0), block, nWeights);
+		for (int i = 0; i < nWeights; i++)
+			gradient[i] += block[i];
+	}
+}
+
+static int SetStatus(EvaluationStatus* status, int code, int layer, int timestep)
+{
+	status->Code = code;
+	status->Layer = layer;
+	status->Timestep = timestep;
+	return code;
+}
+
+// Propagates slab rows [r0, r1) forward a layer at a time. inputs points at the first layer's input for row r0.
+// A layer's input for every row is known once the layer below is done, so its input projection and bias go
+// into the A slab with one GEMM, and only the recurrent term Wr z(t-1) and the activation are left to the
+// sequential loop. The recurrent input for row r0 is row r0 - 1, or the time-zero input if isFirst.
+// The activation kernels report non-finite arguments, and the pass stops at the first: the lowest layer that
+// diverged, at its earliest timestep (rowTime is the time of row 0). Returns an EVAL_* code
+template <typename T>
+static int ForwardRows(TrainingBuffers<T>* b, int numLayers, T* inputs, int r0, int r1, bool isFirst, int rowTime,
+	EvaluationStatus* status)
+{
+	int nt = r1 - r0;
+	for (int l = 0; l < numLayers; l++)
+	{
+		LayerT<T>* layer = b->Layers[l];
+		int nodeCount = layer->NodeCount;
+		int inputCount = layer->InputCount;
+		T* x = l == 0 ? inputs : GetRowPtr(b->Z[l-1], r0);
+		T* a = GetRowPtr(b->A[l], r0);
+		T* z = GetRowPtr(b->Z[l], r0);
+
+		// a = x W' + Bias, for every row
+		for (int r = 0; r < nt; r++)
+			memcpy(a + r * nodeCount, layer->Bias->Data, nodeCount * sizeof(T));
+		BlasGemm(CblasNoTrans, CblasTrans, nt, nodeCount, inputCount,
+			1, x, inputCount, layer->W->Data, inputCount, 1, a, nodeCount);
+
+		if (!layer->IsRecurrent)
+		{
+			if (ActivateLayer(layer, a, z, nt * nodeCount))
+				continue;
+			int r = 0;
+			while (AllFinite(a + r * nodeCount, nodeCount))
+				r++;
+			return SetStatus(status, EVAL_NONFINITE_ACTIVATION, l, rowTime + r0 + r);
+		}
+		SmallKernels<T> kernels = b->Kernels[l];
+		for (int r = 0; r < nt; r++)
+		{
+			T* ar = a + r * nodeCount;
+			T* recurrentInput = r == 0 && isFirst ? b->TimeZeroRecurrentInput->Data : z + (r - 1) * nodeCount;
+			if (kernels.Gemv != NULL)
+				kernels.Gemv(layer->Wr->Data, recurrentInput, ar, nodeCount);
+			else
+				GEMV(1, layer->Wr, recurrentInput, 1, 1, ar);
+			if (!ActivateLayer(layer, ar, z + r * nodeCount, nodeCount))
+				return SetStatus(status, EVAL_NONFINITE_ACTIVATION, l, rowTime + r0 + r);
+		}
+	}
+	return EVAL_OK;
+}
+
+// Fills slab row r of every layer's D. hasNext says whether row r + 1 holds deltas to propagate back in time.
+// target is the desired output at this timestep, or NULL if its output error isn't counted
+template <typename T>
+static inline void BackwardStep(TrainingBuffers<T>* b, int numLayers, int r, bool hasNext, T* target)
+{
+	int l_max = numLayers - 1;
+	LayerT<T>** layers = b->Layers;
+	for (int l = l_max; l >= 0; l--)
+	{
+		LayerT<T>* layer = layers[l];
+		int nodeCount = layer->NodeCount;
+		T* z = GetRowPtr(b->Z[l], r);
+		T* d = GetRowPtr(b->D[l], r);
+		SmallKernels<T> kernels = b->Kernels[l];
+
+		// calculate error propagated to next layer
+		if (l == l_max)
+		{
+			if (target != NULL)
+			{
+				for (int i = 0; i < nodeCount; i++)
+					d[i] = *target - z[i];
+			}
+			else
+				memset(d, 0, nodeCount * sizeof(T));
+		}
+		else if (kernels.GemvT != NULL)
+			kernels.GemvT(layers[l + 1]->W->Data, GetRowPtr(b->D[l + 1], r), d, layers[l + 1]->NodeCount, false);
+		else
+			GEMVT(1, layers[l + 1]->W, GetRowPtr(b->D[l + 1], r), 0, d);
+
+		// calculate error propagated forward in time (recurrently)
+		if (hasNext && layer->IsRecurrent)
+		{
+			if (kernels.GemvT != NULL)
+				kernels.GemvT(layer->Wr->Data, GetRowPtr(b->D[l], r + 1), d, nodeCount, true);
+			else
+				GEMVT(1, layer->Wr, GetRowPtr(b->D[l], r + 1), 1, d);
+		}
+
+		if (layer->ActivationType == ACTIVATION_LOGSIG)
+		{
+			for (int i = 0; i < nodeCount; i++)
+				d[i] *= z[i] * (1 - z[i]);
+		}
+		// else ACTIVATION_PURELIN, derivative is 1
+	}
+}
+
+// half the sum of squared output errors over slab rows [r0, r1). targets holds row r0's desired output
+template <typename T>
+static double OutputError(TrainingBuffers<T>* b, int numLayers, int r0, int r1, T* targets)
+{
+	MatrixT<T>* z = b->Z[numLayers - 1];
+	double totalOutputError = 0;
+	for (int r = r0; r < r1; r++)
+	{
+		T* zr = GetRowPtr(z, r);
+		for (int i = 0; i < z->ColumnCount; i++)
+		{
+			T err = targets[r - r0] - zr[i];
+			totalOutputError += 0.5 * err * err;
+		}
+	}
+	return totalOutputError;
+}
+
+// index of the first non-finite entry, or -1
+static int FirstNonFinite(const double* x, int n)
+{
+	if (AllFinite(x, n))
+		return -1;
+	int i = 0;
+	while (x[i] - x[i] == 0)
+		i++;
+	return i;
+}
+
+// the layer a flat weight or gradient index falls in, in the SetWeights layout
+static int LayerOfWeight(LayerSpec* specs, int numLayers, int nInputs, int index)
+{
+	int inputCount = nInputs;
+	for (int l = 0; l < numLayers; l++)
+	{
+		int nodeCount = specs[l].NodeCount;
+		int count = nodeCount * (inputCount + (specs[l].IsRecurrent ? nodeCount : 0) + 1);
+		if (index < count)
+			return l;
+		index -= count;
+		inputCount = nodeCount;
+	}
+	return numLayers - 1;
+}
+
+#if QUQEMATH_STATS
+// flops per timestep of the forward, backward and gradient phases, for ContextStats
+template <typename T>
+static void GetStepFlops(LayerT<T>** layers, int numLayers, double* forward, double* backward, double* gradient)
+{
+	*forward = *backward = *gradient = 0;
+	for (int l = 0; l < numLayers; l++)
+	{
+		double nodeCount = layers[l]->NodeCount;
+		double inputCount = layers[l]->InputCount;
+		double recurrentCount = layers[l]->IsRecurrent ? nodeCount : 0;
+		*forward += 2 * nodeCount * (inputCount + recurrentCount);
+		*backward += 2 * nodeCount * (recurrentCount + (l > 0 ? inputCount : 0));
+		*gradient += 2 * nodeCount * (inputCount + recurrentCount + 1);
+	}
+}
+#endif
+
+// Points the layers at weights for one evaluation. The double layers view them in place, the float layers a
+// rounded copy
+static void SetContextWeights(TrainingContext* c, double* weights, int nWeights)
+{
+	if (c->Double != NULL)
+		BindLayerViews(c->Double->Layers, c->NumLayers, weights);
+	else
+	{
+		TIME_PHASE(&c->Stats, PHASE_SET_WEIGHTS, 0);
+		ConvertCopy(c->Single->Weights->Data, weights, nWeights);
+	}
+}
+
+// Runs the whole sequence forward, leaving the slabs ready for BackwardPass. output may be NULL
+template <typename T>
+static int ForwardPass(TrainingBuffers<T>* b, int numLayers, int numSamples, double* output, double* error,
+	ContextStats* stats, EvaluationStatus* status)
+{
+	int l_max = numLayers - 1;
+	LayerT<T>** layers = b->Layers;
+#if QUQEMATH_STATS
+	double forwardFlops, backwardFlops, gradientFlops;
+	GetStepFlops(layers, numLayers, &forwardFlops, &backwardFlops, &gradientFlops);
+#endif
+
+	{
+		TIME_PHASE(stats, PHASE_FORWARD, numSamples * forwardFlops);
+		if (ForwardRows(b, numLayers, b->Inputs, 0, numSamples, true, 0, status) != EVAL_OK)
+			return status->Code;
+	}
+	if (output != NULL)
+		ConvertCopy(output, GetRowPtr(b->Z[l_max], numSamples - 1), layers[l_max]->NodeCount);
+	*error = OutputError(b, numLayers, 0, numSamples, b->TrainingOutput);
+	if (!AllFinite(error, 1))
+		return SetStatus(status, EVAL_NONFINITE_GRADIENT, l_max, -1);
+	return EVAL_OK;
+}
+
+// Propagates the error backward through the activations ForwardPass left in the slabs, and sums the gradient
+template <typename T>
+static void BackwardPass(TrainingBuffers<T>* b, int numLayers, int numSamples, double* gradient, int nWeights,
+	ContextStats* stats)
+{
+	int t_max = numSamples - 1;
+#if QUQEMATH_STATS
+	double forwardFlops, backwardFlops, gradientFlops;
+	GetStepFlops(b->Layers, numLayers, &forwardFlops, &backwardFlops, &gradientFlops);
+#endif
+
+	{
+		TIME_PHASE(stats, PHASE_BACKWARD, numSamples * backwardFlops);
+		for (int t = t_max; t >= 0; t--)
+			BackwardStep(b, numLayers, t, t < t_max, b->TrainingOutput + t);
+	}
+
+	TIME_PHASE(stats, PHASE_GRADIENT, numSamples * gradientFlops);
+	AccumulateGradient(b, numLayers, numSamples, gradient, nWeights);
+}
+
+// Truncated BPTT. The sequence is run forward stride timesteps at a time, the state carrying over. After each
+// chunk the output errors of its timesteps are backpropagated through the last window timesteps only, and
+// that window's gradient is added to the total. The slabs hold the window and the timestep before it, whose
+// outputs are the window's first recurrent input: row r holds time tBase + r, and the slabs slide along as
+// tBase advances. The error is the same as EvaluateWeights'; the gradient ignores what each error would have
+// contributed through timesteps more than window back. A NULL gradient runs the forward chunks only; output may
+// be NULL too
+template <typename T>
+static int EvaluateWeightsTruncated(TrainingBuffers<T>* b, int numLayers, int numSamples, int window, int stride,
+	int nWeights, double* output, double* error, double* gradient, ContextStats* stats, EvaluationStatus* status)
+{
+	double totalOutputError = 0;
+	int l_max = numLayers - 1;
+	LayerT<T>** layers = b->Layers;
+	T* block = b->GradientBlock->Data;
+	int tBase = 0;
+#if QUQEMATH_STATS
+	double forwardFlops, backwardFlops, gradientFlops;
+	GetStepFlops(layers, numLayers, &forwardFlops, &backwardFlops, &gradientFlops);
+#endif
+
+	if (gradient != NULL)
+		memset(gradient, 0, nWeights * sizeof(double));
+	for (int t0 = 0; t0 < numSamples; t0 += stride)
+	{
+		int t1 = t0 + stride < numSamples ? t0 + stride : numSamples;
+		int w0 = t1 - window > 0 ? t1 - window : 0;
+
+		// slide the slabs to start at the timestep before the window. Only Z is carried over; A and D are
+		// rewritten before they are read
+		int keepFrom = w0 > 0 ? w0 - 1 : 0;
+		if (keepFrom > tBase)
+		{
+			for (int l = 0; l < numLayers; l++)
+			{
+				MatrixT<T>* z = b->Z[l];
+				memmove(z->Data, GetRowPtr(z, keepFrom - tBase), (t0 - keepFrom) * z->ColumnCount * sizeof(T));
+			}
+			tBase = keepFrom;
+		}
+
+		{
+			TIME_PHASE(stats, PHASE_FORWARD, (t1 - t0) * forwardFlops);
+			if (ForwardRows(b, numLayers, b->GetInputRow(t0), t0 - tBase, t1 - tBase, t0 == 0, tBase, status) != EVAL_OK)
+				return status->Code;
+		}
+		totalOutputError += OutputError(b, numLayers, t0 - tBase, t1 - tBase, b->TrainingOutput + t0);
+		if (!AllFinite(&totalOutputError, 1))
+			return SetStatus(status, EVAL_NONFINITE_GRADIENT, l_max, -1);
+		if (gradient == NULL)
+			continue;
+
+		{
+			TIME_PHASE(stats, PHASE_BACKWARD, (t1 - w0) * backwardFlops);
+			for (int t = t1 - 1; t >= w0; t--)
+				BackwardStep(b, numLayers, t - tBase, t < t1 - 1, t >= t0 ? b->TrainingOutput + t : NULL);
+		}
+
+		TIME_PHASE(stats, PHASE_GRADIENT, (t1 - w0) * gradientFlops);
+		ComputeGradient(b, numLayers, w0 - tBase, t1 - tBase, b->GetInputRow(w0), block, nWeights);
+		for (int i = 0; i < nWeights; i++)
+			gradient[i] += block[i];
+	}
+	if (output != NULL)
+		ConvertCopy(output, GetRowPtr(b->Z[l_max], numSamples - 1 - tBase), layers[l_max]->NodeCount);
+	*error = totalOutputError;
+	return EVAL_OK;
+}
+
+// Forward pass, then backward unless gradient is NULL, straight into the caller's buffers. The layers view
+// weights for this call only. An error-only forward pass is left in the slabs for EvaluateGradient
+static void RunEvaluation(TrainingContext* c, double* weights, int nWeights, double* output, double* error,
+	double* gradient)
+{
+	EvaluationStatus* status = &c->LastStatus;
+	int badWeight = FirstNonFinite(weights, nWeights);
+	if (badWeight >= 0)
+	{
+		SetStatus(status, EVAL_NONFINITE_WEIGHTS, LayerOfWeight(c->LayerSpecs, c->NumLayers, c->NumInputs, badWeight), -1);
+		return;
+	}
+	SetContextWeights(c, weights, nWeights);
+	if (c->BpttWindow > 0)
+	{
+		if (c->Double != NULL)
+			EvaluateWeightsTruncated(c->Double, c->NumLayers, c->NumSamples, c->BpttWindow, c->BpttStride,
+				nWeights, output, error, gradient, &c->Stats, status);
+		else
+			EvaluateWeightsTruncated(c->Single, c->NumLayers, c->NumSamples, c->BpttWindow, c->BpttStride,
+				nWeights, output, error, gradient, &c->Stats, status);
+		return;
+	}
+	if (c->Double != NULL)
+		ForwardPass(c->Double, c->NumLayers, c->NumSamples, output, error, &c->Stats, status);
+	else
+		ForwardPass(c->Single, c->NumLayers, c->NumSamples, output, error, &c->Stats, status);
+	if (status->Code != EVAL_OK)
+		return;
+	if (gradient == NULL)
+		c->ForwardPassPending = true;
+	else if (c->Double != NULL)
+		BackwardPass(c->Double, c->NumLayers, c->NumSamples, gradient, nWeights, &c->Stats);
+	else
+		BackwardPass(c->Single, c->NumLayers, c->NumSamples, gradient, nWeights, &c->Stats);
+}
+
+// Backward pass over the forward pass EvaluateError left in the slabs. The float layers still hold the rounded
+// weights it loaded
+static void ResumeEvaluation(TrainingContext* c, double* weights, int nWeights, double* gradient)
+{
+	if (c->Double != NULL)
+	{
+		BindLayerViews(c->Double->Layers, c->NumLayers, weights);
+		BackwardPass(c->Double, c->NumLayers, c->NumSamples, gradient, nWeights, &c->Stats);
+	}
+	else
+		BackwardPass(c->Single, c->NumLayers, c->NumSamples, gradient, nWeights, &c->Stats);
+}
+
+// Runs or resumes an evaluation, then checks its gradient and fills in the results of a failed one. output may
+// be NULL; error may not
+static int Evaluate(TrainingContext* c, double* weights, int nWeights, double* output, double* error, double* gradient,
+	bool resume)
+{
+	assert(nWeights == c->NumWeights);
+	int allocationsBefore = ThreadAllocationCount;
+	long long bytesBefore = ThreadAllocatedBytes;
+	EvaluationStatus* status = &c->LastStatus;
+	c->ForwardPassPending = false;
+	if (resume)
+		ResumeEvaluation(c, weights, nWeights, gradient);
+	else
+	{
+		SetStatus(status, EVAL_OK, -1, -1);
+		RunEvaluation(c, weights, nWeights, output, error, gradient);
+	}
+
+	// finite activations and errors can still overflow the gradient
+	if (status->Code == EVAL_OK && gradient != NULL)
+	{
+		int badGradient = FirstNonFinite(gradient, nWeights);
+		if (badGradient >= 0)
+			SetStatus(status, EVAL_NONFINITE_GRADIENT,
+				LayerOfWeight(c->LayerSpecs, c->NumLayers, c->NumInputs, badGradient), -1);
+	}
+	if (status->Code != EVAL_OK)
+	{
+		// the passes stop at the failure, so nothing they left behind is meaningful
+		c->ForwardPassPending = false;
+		if (output != NULL)
+			for (int i = 0; i < c->LayerSpecs[c->NumLayers - 1].NodeCount; i++)
+				output[i] = std::numeric_limits<double>::quiet_NaN();
+		*error = std::numeric_limits<double>::quiet_NaN();
+		if (gradient != NULL)
+			memset(gradient, 0, nWeights * sizeof(double));
+	}
+
+	c->EvaluationAllocationCount = ThreadAllocationCount - allocationsBefore;
+#if QUQEMATH_STATS
+	if (resume)
+		c->Stats.ResumedEvaluations++;
+	else if (status->Code != EVAL_NONFINITE_WEIGHTS) // rejected weights run no pass
+		c->Stats.Evaluations++;
+	c->Stats.Allocations += c->EvaluationAllocationCount;
+	c->Stats.BytesAllocated += ThreadAllocatedBytes - bytesBefore;
+#endif
+	return status->Code;
+}
+
+QUQEMATH_API int EvaluateWeights(TrainingContext* c, double* weights, int nWeights, double* output, double* error, double* gradient)
+{
+	return Evaluate(c, weights, nWeights, output, error, gradient, false);
+}
+
+QUQEMATH_API int EvaluateError(TrainingContext* c, double* weights, int nWeights, double* output, double* error)
+{
+	return Evaluate(c, weights, nWeights, output, error, NULL, false);
+}
+
+QUQEMATH_API int EvaluateGradient(TrainingContext* c, double* weights, int nWeights, double* gradient)
+{
+	double error = 0;
+	return Evaluate(c, weights, nWeights, NULL, &error, gradient, c->ForwardPassPending);
+}
+
+QUQEMATH_API int GetEvaluationStatus(TrainingContext* c, EvaluationStatus* status)
+{
+	*status = c->LastStatus;
+	return status->Code;
+}
+
+QUQEMATH_API void PropagateInput(PropagationContext* c, double* input, double* output)
+{
+	Propagate(input, 1, c->NumLayers, c->Layers, c->Layers, NULL);
+	Layer* lastLayer = c->Layers[c->NumLayers-1];
+	memcpy(output, lastLayer->z->Data, lastLayer->NodeCount * sizeof(double));
+}
+
+// Same as calling PropagateInput on each column of inputs in turn. inputs is nInputs x nSteps, row-major
+// with rows ldInputs apart (0 means nSteps), so a run of columns inside a wider matrix can be passed without
+// copying. outputs receives nSteps rows of the output layer's values
+QUQEMATH_API void PropagateSequence(PropagationContext* c, double* inputs, int nInputs, int nSteps, double* outputs,
+	int ldInputs)
+{
+	assert(nInputs == c->NumInputs);
+	if (ldInputs == 0)
+		ldInputs = nSteps;
+	assert(ldInputs >= nSteps);
+	Layer* lastLayer = c->Layers[c->NumLayers-1];
+	int outputCount = lastLayer->NodeCount;
+	for (int t = 0; t < nSteps; t++)
+	{
+		Propagate(inputs + t, ldInputs, c->NumLayers, c->Layers, c->Layers, NULL);
+		memcpy(outputs + t * outputCount, lastLayer->z->Data, outputCount * sizeof(double));
+	}
+}
+
+// timeZeroRecurrentInput stands in for the previous layers' outputs when prevLayers is NULL
+void Propagate(double* input, int inputStride, int numLayers, Layer** currLayers, Layer** prevLayers,
+	Vector* timeZeroRecurrentInput)
+{
+	for (int l = 0; l < numLayers; l++)
+	{
+		Layer* layer = currLayers[l];
+		PropagateLayer(input, inputStride, layer, prevLayers != NULL ? prevLayers[l]->z->Data : timeZeroRecurrentInput->Data,
+			layer->a->Data, layer->z->Data);
+		input = layer->z->Data;
+		inputStride = 1;
+	}
+}
+
+template <typename T>
+static void AssertNoNaNs(T* xs, int count)
+{
+	for (int i=0; i<count; i++)
+		assert(!_isnan(xs[i]));
+}
+
+// a and z receive the layer's activations and outputs. z may alias recurrentInput since it isn't written until a is done
+template <typename T>
+void PropagateLayer(T* input, int inputStride, LayerT<T>* layer, T* recurrentInput, T* a, T* z)
+{
+	int nodeCount = layer->NodeCount;
+
+#if DEBUG
+	AssertNoNaNs(input, layer->InputCount);
+	if (layer->IsRecurrent)
+		AssertNoNaNs(recurrentInput, nodeCount);
+#endif
+
+	// compute a
+	memcpy(a, layer->Bias->Data, nodeCount * sizeof(T));
+	GEMV(1, layer->W, input, inputStride, 1, a);
+	if (layer->IsRecurrent)
+		GEMV(1, layer->Wr, recurrentInput, 1, 1, a);
+
+	ActivateLayer(layer, a, z, nodeCount);
+
+#if DEBUG
+	AssertNoNaNs(z, nodeCount);
+#endif
+}
+
+template <typename T>
+void SetWeights(LayerT<T>** layers, int numLayers, double* weights, int nWeights)
+{
+	double* dp = weights;
+	for (int layer = 0; layer < numLayers; layer++)
+	{
+		LayerT<T>* l = layers[layer];
+		dp = SetMatrixWeights(l->W, dp);
+		if (l->IsRecurrent)
+			dp = SetMatrixWeights(l->Wr, dp);
+		dp = SetVectorWeights(l->Bias, dp);
+	}
+	assert(weights + nWeights == dp);
+}
+
+template <typename T>
+double* SetVectorWeights(VectorT<T>* v, double* weights)
+{
+	int len = v->Count;
+	ConvertCopy(v->Data, weights, len);
+	return weights + len;
+}
+
+template <typename T>
+double* SetMatrixWeights(MatrixT<T>* m, double* weights)
+{
+	int len = m->RowCount * m->ColumnCount;
+	ConvertCopy(m->Data, weights, len);
+	return weights + len;
+}
+
+// counts in the same order SetWeights/GetWeights lay weights out: W, then Wr if recurrent, then Bias, for each layer.
+// touches no shared state, so it is safe to call from any thread
+int GetWeightCount(LayerSpec* layerSpecs, int nLayers, int nInputs)
+{
+	int nWeights = 0;
+	int inputCount = nInputs;
+	for (int l = 0; l < nLayers; l++)
+	{
+		int nodeCount = layerSpecs[l].NodeCount;
+		nWeights += nodeCount * inputCount;
+		if (layerSpecs[l].IsRecurrent)
+			nWeights += nodeCount * nodeCount;
+		nWeights += nodeCount;
+		inputCount = nodeCount;
+	}
+	return nWeights;
+}
+
+int GetWeights(Layer** layers, int numLayers, double* weights, int nWeights)
+{
+	double* dp = weights;
+	for (int layer = 0; layer < numLayers; layer++)
+	{
+		Layer* l = layers[layer];
+		dp = GetMatrixWeights(l->W, dp);
+		if (l->IsRecurrent)
+			dp = GetMatrixWeights(l->Wr, dp);
+		dp = GetVectorWeights(l->Bias, dp);
+	}
+	assert(weights + nWeights == dp);
+	int result = dp - weights;
+	return result;
+}
+
+double* GetVectorWeights(Vector* v, double* weights)
+{
+	int len = v->Count;
+	memcpy(weights, v->Data, len * sizeof(double));
+	return weights + len;
+}
+
+double* GetMatrixWeights(Matrix* m, double* weights)
+{
+	int len = m->RowCount * m->ColumnCount;
+	memcpy(weights, m->Data, len * sizeof(double));
+	return weights + len;
+}
+
+template <typename T>
+VectorT<T>* MakeTimeZeroRecurrentInput(int size)
+{
+	VectorT<T>* v = new VectorT<T>(size);
+	T* vData = v->Data;
+	for (int i = 0; i < size; i++)
+		vData[i] = (T)TimeZeroRecurrentInputValue;
+	return v;
+}
+
+template void PropagateLayer(double* input, int inputStride, LayerT<double>* layer, double* recurrentInput, double* a, double* z);
+template void PropagateLayer(float* input, int inputStride, LayerT<float>* layer, float* recurrentInput, float* a, float* z);
+template void SetWeights(LayerT<double>** layers, int numLayers, double* weights, int nWeights);
+template void SetWeights(LayerT<float>** layers, int numLayers, double* weights, int nWeights);
+template VectorT<double>* MakeTimeZeroRecurrentInput<double>(int size);
+template VectorT<float>* MakeTimeZeroRecurrentInput<float>(int size);
@@ -1,170 +1,625 @@
-// The following ifdef block is the standard way of creating macros which make exporting 
-// from a DLL simpler. All files within this DLL are compiled with the QUQEMATH_EXPORTS
-// symbol defined on the command line. This symbol should not be defined on any project
-// that uses this DLL. This way any other project whose source files include this file see 
-// QUQEMATH_API functions as being imported from a DLL, whereas this DLL sees symbols
-// defined with this macro as being exported.
-#ifdef QUQEMATH_EXPORTS
-#define QUQEMATH_API __declspec(dllexport)
-#else
-#define QUQEMATH_API __declspec(dllimport)
-#endif
-
-#include <float.h>
-#include "LinReg.h"
-
-const int ACTIVATION_LOGSIG = 0;
-const int ACTIVATION_PURELIN = 1;
-const double TimeZeroRecurrentInputValue = 0.5;
-
-struct LayerSpec
-{
-  int NodeCount;
-  bool IsRecurrent;
-  int ActivationType;
-};
-
-typedef double(*ActivationFunc)(double);
-
-class Layer
-{
-public:
-	Matrix* W;
-  Matrix* Wr;
-  Vector* Bias;
-  Vector* x;
-  Vector* a;
-  Vector* z;
-  Vector* d;
-  bool IsRecurrent;
-  int ActivationType;
-  int NodeCount;
-  int InputCount;
-
-  Layer(Matrix* w, Matrix* wr, Vector* bias, bool isRecurrent, int activationType);
-	void DeleteWeights();
-  ~Layer();
-};
-
-class Frame
-{
-public:
-  Layer** Layers;
-  int NumLayers;
-
-  Frame(Layer** layers, int numLayers);
-  ~Frame();
-};
-
-class TrainingContext
-{
-public:
-  Matrix* TrainingInput;
-  Vector* TrainingOutput;
-	int NumFrames;
-  Frame** Frames;
-  int NumLayers;
-  LayerSpec* LayerSpecs;
-
-public:
-  TrainingContext(const Matrix &trainingInput, const Vector &trainingOutput, int nFrames, Frame** frames, int nLayers, LayerSpec* specs);
-  ~TrainingContext();
-};
-
-class OrthoContext
-{
-public:
-  Vector* Pv;
-  Matrix* Bases;
-  Vector* Dp;
-
-  OrthoContext(int basisDimension, int maxBasisCount);
-  ~OrthoContext();
-};
-
-extern "C" {
-  
-QUQEMATH_API void* CreateTrainingContext(
-	LayerSpec* layerSpecs, int nLayers,
-	double* trainingData, double* outputData,
-	int nInputs, int nSamples);
-
-QUQEMATH_API void EvaluateWeights(TrainingContext* c, double* weights, int nWeights,
-  double* output, double* error, double* gradient);
-
-QUQEMATH_API void DestroyTrainingContext(void* context);
-
-}
-
-extern "C" {
-
-QUQEMATH_API void* CreatePropagationContext(
-	LayerSpec* layerSpecs, int nLayers,
-	int nInputs,
-	double* weights, int nWeights);
-
-QUQEMATH_API void PropagateInput(Frame** frame, double* input, double* output);
-
-QUQEMATH_API void DestroyPropagationContext(void* context);
-
-}
-
-extern "C" {
-
-QUQEMATH_API void* CreateOrthoContext(int basisDimension, int maxBasisCount);
-QUQEMATH_API void Orthogonalize(OrthoContext* c, double* p, int numBases, double* orthonormalBases);
-QUQEMATH_API void DestroyOrthoContext(void* context);
-
-}
-
-extern "C" QUQEMATH_API int GetWeightCount(LayerSpec* layerSpecs, int nLayers, int nInputs);
-
-Frame** LayersToFrames(Layer** protoLayers, int nLayers, int nSamples);
-void DeleteFrames(Frame** frames, int nSamples);
-void DeleteLayers(Layer** layers, int nLayers, bool deleteWeights);
-
-void Propagate(double* input, int inputStride, int numLayers, Layer** currLayers, Layer** prevLayers);
-void PropagateLayer(double* input, int inputStride, Layer* layer, Vector* recurrentInput);
-void ApplyActivationFunction(Vector* a, ActivationFunc f);
-Layer** SpecsToLayers(int numInputs, LayerSpec* specs, int numLayers);
-Vector* MakeTimeZeroRecurrentInput(int size);
-
-void SetWeights(Layer** layers, int numLayers, double* weights, int nWeights);
-double* SetVectorWeights(Vector* v, double* weights);
-double* SetMatrixWeights(Matrix* m, double* weights);
-
-int GetWeights(Layer** layers, int numLayers, double* weights, int nWeights);
-double* GetVectorWeights(Vector* v, double* weights);
-double* GetMatrixWeights(Matrix* m, double* weights);
-
-double Linear(double x);
-double LinearPrime(double x);
-double LogisticSigmoidPrime(double x);
-
-inline double Linear(double x)
-{
-  return x;
-}
-
-inline double LinearPrime(double x)
-{
-  return 1;
-}
-
-//#define LogisticSigmoid(x)    (1 / (1 + exp(-(x))))
-
-inline double LogisticSigmoid(double x)
-{
-  // without this, exp(-x) can overflow, but the FPU handles it ok: 1 / (1 + INF) == 0
-  //static const double xmin = -log(DBL_MAX-1);
-  //if (x <= xmin)
-  //  return 0;
-
-  return 1.0 / (1.0 + exp(-x));
-}
-
-inline double LogisticSigmoidPrime(double x)
-{
-  double v = LogisticSigmoid(x);
-  return v * (1 - v);
+// The following ifdef block is the standard way of creating macros which make exporting 
+// from a DLL simpler. All files within this DLL are compiled with the QUQEMATH_EXPORTS
+// symbol defined on the command line. This symbol should not be defined on any project
+// that uses this DLL. This way any other project whose source files include this file see 
+// QUQEMATH_API functions as being imported from a DLL, whereas this DLL sees symbols
+// defined with this macro as being exported.
+#if !defined(_WIN32)
+#define QUQEMATH_API __attribute__((visibility("default")))
+#elif defined(QUQEMATH_EXPORTS)
+#define QUQEMATH_API __declspec(dllexport)
+#else
+#define QUQEMATH_API __declspec(dllimport)
+#endif
+
+#include <float.h>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <deque>
+#include <vector>
+#include "LinReg.h"
+
+const int ACTIVATION_LOGSIG = 0;
+const int ACTIVATION_PURELIN = 1;
+const int ACTIVATION_KERNEL_SCALAR = 0;
+const int ACTIVATION_KERNEL_AVX2 = 1;
+const int ACTIVATION_KERNEL_AVX512 = 2;
+const double TimeZeroRecurrentInputValue = 0.5;
+const int PRECISION_DOUBLE = 0;
+const int PRECISION_SINGLE = 1; // float activations and gradients
+const int PRECISION_MIXED = 2; // float activations, gradients summed in double
+const int MixedPrecisionGradientBlock = 64; // timesteps summed in float before adding into the double gradient
+
+// EvaluateWeights status codes. Evaluation stops at the first non-finite value found
+const int EVAL_OK = 0;
+const int EVAL_NONFINITE_WEIGHTS = 1;
+const int EVAL_NONFINITE_ACTIVATION = 2;
+const int EVAL_NONFINITE_GRADIENT = 3; // the error or gradient, with every activation finite
+
+struct EvaluationStatus
+{
+  int Code; // EVAL_*
+  int Layer; // of the first non-finite weight, activation or gradient entry; -1 if EVAL_OK
+  int Timestep; // of the first non-finite activation; otherwise -1
+};
+
+// QUQEMATH_STATS=0 compiles out the per-context phase counters and timers; GetContextStats then returns 0
+#ifndef QUQEMATH_STATS
+#define QUQEMATH_STATS 1
+#endif
+
+// phases of a TrainingContext's life that ContextStats times
+const int PHASE_SETUP = 0; // context construction
+const int PHASE_SET_WEIGHTS = 1; // rounding the weights for float layers. Double layers view them in place, untimed
+const int PHASE_FORWARD = 2;
+const int PHASE_BACKWARD = 3; // the delta recursion
+const int PHASE_GRADIENT = 4; // the gradient GEMMs
+const int PHASE_COUNT = 5;
+
+struct PhaseStats
+{
+  long long Calls; // timed sections. A truncated BPTT evaluation enters each phase once per chunk
+  long long Nanoseconds;
+  double Flops; // 2 per multiply-add in the matrix products
+};
+
+struct ContextStats
+{
+  PhaseStats Phases[PHASE_COUNT];
+  long long Evaluations; // calls that ran a forward pass
+  long long ResumedEvaluations; // EvaluateGradient calls that ran only the backward pass, over EvaluateError's forward pass
+  long long Allocations; // Vector/Matrix buffers, during setup and evaluations
+  long long BytesAllocated;
+};
+
+struct LayerSpec
+{
+  int NodeCount;
+  bool IsRecurrent;
+  int ActivationType;
+};
+
+typedef double(*ActivationFunc)(double);
+
+template <typename T>
+class LayerT
+{
+public:
+	MatrixT<T>* W;
+  MatrixT<T>* Wr;
+  VectorT<T>* Bias;
+  VectorT<T>* a; // single-step activations, used by PropagationContext
+  VectorT<T>* z;
+  bool IsRecurrent;
+  int ActivationType;
+  int NodeCount;
+  int InputCount;
+
+  // hasStepState allocates a and z. Training layers keep their activations in slabs and leave them NULL
+  LayerT(MatrixT<T>* w, MatrixT<T>* wr, VectorT<T>* bias, bool isRecurrent, int activationType,
+    bool hasStepState);
+	void DeleteWeights();
+  ~LayerT();
+};
+
+typedef LayerT<double> Layer;
+
+class PropagationContext
+{
+public:
+  int NumInputs;
+  int NumLayers;
+  Layer** Layers; // each layer's z carries its recurrent state from one step to the next
+
+  PropagationContext(LayerSpec* specs, int nLayers, int nInputs, double* weights, int nWeights);
+  ~PropagationContext();
+  int StateSize();
+};
+
+// Training inputs and outputs in native memory, shared by every TrainingContext made over them. The inputs are
+// stored one timestep per row, so a context's run of timesteps is a run of rows that it reads in place.
+// Refcounted: the creator and each context hold a reference, and the last Release deletes the data set
+class SharedDataSet
+{
+public:
+  int NumInputs;
+  int NumSamples;
+  Matrix* Inputs; // NumSamples x NumInputs, row t is the input at time t
+  Vector* Outputs;
+
+  SharedDataSet(double* trainingData, double* outputData, int nInputs, int nSamples);
+  void AddRef();
+  void Release();
+  // float copies for single and mixed precision contexts, made on first use
+  MatrixT<float>* GetInputsF();
+  VectorT<float>* GetOutputsF();
+
+private:
+  std::atomic<int> RefCount;
+  std::once_flag SingleCopyOnce;
+  MatrixT<float>* InputsF;
+  VectorT<float>* OutputsF;
+  ~SharedDataSet();
+};
+
+// Matrix-vector products specialized on the matrix's column count, for the per-timestep recurrences of small
+// layers. The matrix is row-major with m rows. NULL members mean the column count is too large; use BLAS
+template <typename T>
+struct SmallKernels
+{
+  void (*Gemv)(const T* w, const T* x, T* y, int m); // y += W x
+  void (*GemvT)(const T* w, const T* x, T* y, int m, bool accumulate); // y = W' x, or y += W' x if accumulate
+};
+
+// past this BLAS is as fast, and the kernel table would only grow the binary
+const int SmallKernelMaxColumns = 12;
+
+template <typename T>
+SmallKernels<T> GetSmallKernels(int columnCount);
+
+// The precision-dependent part of a TrainingContext. Activations are stored per layer as one
+// SlabRows x NodeCount slab, so a layer's values at time t are one contiguous row
+template <typename T>
+class TrainingBuffers
+{
+public:
+  int NumLayers;
+  int NumInputs;
+  LayerT<T>** Layers; // weights only, as views into the flat weights; activations live in the slabs below
+  VectorT<T>* Weights; // the flat weights Layers view, when the buffers own them. NULL if Layers are bound to the
+                       // caller's weights for the length of each evaluation
+  T* Inputs; // NumSamples x NumInputs, row t is the input at time t. Points into the context's SharedDataSet
+  T* TrainingOutput; // likewise
+  int SlabRows; // NumSamples, or the truncated BPTT window plus one
+  MatrixT<T>** A; // per layer, SlabRows x NodeCount. Row t holds the layer's values at time t (t - tBase when truncated)
+  MatrixT<T>** Z;
+  MatrixT<T>** D;
+  VectorT<T>* Ones; // SlabRows ones, for summing bias gradients
+  VectorT<T>* TimeZeroRecurrentInput; // sized for the widest layer
+  int GradientBlockLength; // timesteps per gradient GEMM
+  VectorT<T>* GradientBlock; // one block's or window's gradient, before it is added to the double result. NULL if unused
+  SmallKernels<T>* Kernels; // per layer, for its node count, which is the column count of its Wr and the next layer's W
+
+  TrainingBuffers(LayerSpec* specs, int nLayers, bool ownsWeights, T* inputs, T* trainingOutput, int nInputs, int slabRows,
+    int gradientBlockLength);
+  ~TrainingBuffers();
+  T* GetInputRow(int t) { return Inputs + t * NumInputs; }
+};
+
+// whether CreateTrainingContext accepts these
+bool ValidBpttArguments(int bpttWindow, int bpttStride);
+bool ValidDataWindow(SharedDataSet* data, int offset, int length);
+
+class TrainingContext
+{
+public:
+  int NumSamples;
+  int NumInputs;
+  int NumLayers;
+  LayerSpec* LayerSpecs;
+  SharedDataSet* Data; // holds a reference
+  int DataOffset; // timestep of Data that is this context's time zero
+  int Precision;
+  int BpttWindow; // truncated BPTT: timesteps backpropagated through. 0 for the whole sequence
+  int BpttStride; // truncated BPTT: timesteps between backward passes
+  TrainingBuffers<double>* Double; // set for PRECISION_DOUBLE
+  TrainingBuffers<float>* Single; // set for PRECISION_SINGLE and PRECISION_MIXED
+  int EvaluationAllocationCount; // Vector/Matrix allocations made by the last EvaluateWeights call
+  EvaluationStatus LastStatus; // of the last EvaluateWeights call
+  int NumWeights;
+  bool ForwardPassPending; // the slabs hold the forward pass of a successful EvaluateError, for EvaluateGradient
+  ContextStats Stats; // accumulated since construction or the last ResetContextStats. All zero if QUQEMATH_STATS is 0
+
+public:
+  TrainingContext(LayerSpec* specs, int nLayers, SharedDataSet* data, int offset, int length,
+    int precision, int bpttWindow, int bpttStride);
+  ~TrainingContext();
+};
+
+class BatchTrainingContext
+{
+public:
+  int BatchSize;
+  int NumSamples; // timesteps per sequence
+  int NumInputs;
+  int NumLayers;
+  LayerSpec* LayerSpecs;
+  Layer** Layers; // weights only; activations live in the slabs below
+  Matrix* Inputs; // (BatchSize * NumSamples) x NumInputs
+  Matrix* Outputs; // BatchSize x NumSamples
+  Matrix** A; // per layer, (BatchSize * NumSamples) x NodeCount
+  Matrix** Z;
+  Matrix** D;
+  Matrix* TimeZeroRecurrentInput; // BatchSize x (widest layer)
+  Vector* Ones; // NumSamples ones, for summing bias gradients
+
+  BatchTrainingContext(LayerSpec* specs, int nLayers, double* trainingData, double* outputData,
+    int nInputs, int nSamples, int* windowOffsets, int nWindows, int windowLength);
+  ~BatchTrainingContext();
+};
+
+// candidates are orthogonalized this many at a time, which bounds the projection scratch space
+const int OrthoBlockSize = 64;
+
+// an orthonormal basis that grows one vector at a time, for Gram-Schmidt against everything appended so far
+class OrthoContext
+{
+public:
+  int BasisDimension;
+  int MaxBasisCount;
+  Matrix* Bases; // one basis per row; RowCount is the number appended
+  Matrix* Projections; // MaxBasisCount x OrthoBlockSize
+
+  OrthoContext(int basisDimension, int maxBasisCount);
+  ~OrthoContext();
+};
+
+// one expert of an EnsembleContext: either an RNN or an RBF network, reading NumInputs rows of the
+// ensemble's input matrix starting at InputOffset
+class EnsembleMember
+{
+public:
+  int InputOffset;
+  int NumInputs;
+  PropagationContext* Rnn; // NULL for RBF members
+  Matrix* Centers; // RBF members: nCenters x NumInputs
+  Vector* Weights;
+  double OutputBias;
+  double Spread;
+  bool IsDegenerate;
+
+  EnsembleMember(int inputOffset, int nInputs);
+  ~EnsembleMember();
+  void Predict(double* inputs, int nSteps, int ldInputs, double* outputs);
+};
+
+class EnsembleContext
+{
+public:
+  int NumInputs; // rows of the shared input matrix
+  int NumMembers;
+  int MaxMembers;
+  EnsembleMember** Members;
+
+  EnsembleContext(int nInputs, int maxMembers);
+  ~EnsembleContext();
+};
+
+// called on the worker thread that ran the job, once its result can be read
+typedef void (*TrainingJobCallback)(int job, void* state);
+
+// one TrainSCG run for a TrainingScheduler
+class TrainingJob
+{
+public:
+  int Id; // assigned by TrainingScheduler::Submit
+  LayerSpec* LayerSpecs;
+  int NumLayers;
+  SharedDataSet* Data; // holds a reference until the job is destroyed
+  int Offset;
+  int Length;
+  int Precision;
+  int BpttWindow;
+  int BpttStride;
+  Vector* InitialWeights;
+  int EpochMax;
+  double Tau;
+  volatile int Canceled; // polled by TrainSCG
+
+  // results, valid once Finished is set
+  Vector* FinalWeights;
+  Vector* CostHistory; // EpochMax + 1 entries, NumCosts of them written
+  int NumCosts; // 0 if the job was canceled before it started
+  EvaluationStatus Status;
+  double Seconds; // spent training
+  std::atomic<bool> Finished;
+
+  TrainingJob(LayerSpec* specs, int nLayers, SharedDataSet* data, int offset, int length, int precision,
+    int bpttWindow, int bpttStride, double* initialWeights, int nWeights, int epochMax, double tau);
+  ~TrainingJob();
+  // whether a context made for other can train this job
+  bool CanShareContext(TrainingJob* other);
+};
+
+// A pool of threads running TrainingJobs. Each thread has its own queue, which it works through in submission
+// order, and when that runs dry it steals from the fullest other queue, so no thread sits idle while another
+// still has jobs waiting. Submitting the longest jobs first keeps the last one to finish short. A thread keeps
+// its training context for the next job if the job has the same layers, data window and options
+class TrainingScheduler
+{
+public:
+  int NumThreads;
+  TrainingJobCallback Callback;
+  void* CallbackState;
+
+  TrainingScheduler(int nThreads, TrainingJobCallback callback, void* callbackState);
+  ~TrainingScheduler();
+  int Submit(TrainingJob* job); // takes ownership and returns the job's id
+  TrainingJob* GetJob(int id);
+  void Cancel(int id);
+  void Wait();
+
+private:
+  struct WorkQueue
+  {
+    std::mutex Lock;
+    std::deque<TrainingJob*> Jobs;
+    std::atomic<int> Count; // Jobs.size(), for choosing a victim without taking every lock
+  };
+
+  std::vector<std::thread> Threads;
+  std::vector<WorkQueue*> Queues;
+  std::mutex JobsLock; // guards Jobs and NextQueue
+  std::vector<TrainingJob*> Jobs; // by Id
+  int NextQueue;
+  std::mutex StateLock; // guards the rest, and is held while submitting so waiting workers don't miss the job
+  std::condition_variable WorkAvailable;
+  std::condition_variable AllFinished;
+  std::atomic<int> NumQueued; // the queues' total, changed under the lock of the queue pushed to or taken from
+  int NumUnfinished;
+  bool Stopping;
+
+  TrainingJob* Take(int thread);
+  void Run(TrainingJob* job, TrainingContext*& context, TrainingJob*& contextJob);
+  void WorkerLoop(int thread);
+};
+
+extern "C" {
+  
+// precision is one of the PRECISION_* constants. Weights, outputs, errors and gradients are passed as
+// double whatever the precision. A nonzero bpttWindow selects truncated BPTT: every bpttStride timesteps
+// (at most bpttWindow), the errors of those timesteps are backpropagated through the last bpttWindow
+// timesteps only, and just bpttWindow + 1 timesteps of activations are kept. Returns NULL unless nSamples is
+// positive and bpttWindow is 0, or positive with bpttStride in [1, bpttWindow]
+QUQEMATH_API void* CreateTrainingContext(
+	LayerSpec* layerSpecs, int nLayers,
+	double* trainingData, double* outputData,
+	int nInputs, int nSamples, int precision, int bpttWindow, int bpttStride);
+
+// trainingData is nInputs x nSamples, one sample per column. The data set is returned holding one reference
+QUQEMATH_API void* CreateDataSet(double* trainingData, double* outputData, int nInputs, int nSamples);
+QUQEMATH_API void ReleaseDataSet(SharedDataSet* data);
+
+// Like CreateTrainingContext, over timesteps [offset, offset + length) of a data set, which is used in place.
+// Also returns NULL if that window isn't within the data set
+QUQEMATH_API void* CreateTrainingContextOnDataSet(LayerSpec* layerSpecs, int nLayers, SharedDataSet* data,
+  int offset, int length, int precision, int bpttWindow, int bpttStride);
+
+// Returns an EVAL_* code. On failure output and error are NaN and gradient is zero; GetEvaluationStatus says where it failed.
+// weights are read in place and not kept after the call
+QUQEMATH_API int EvaluateWeights(TrainingContext* c, double* weights, int nWeights,
+  double* output, double* error, double* gradient);
+
+// EvaluateWeights without the backward pass
+QUQEMATH_API int EvaluateError(TrainingContext* c, double* weights, int nWeights, double* output, double* error);
+
+// The gradient for the weights of the EvaluateError call just made, which must be given again unchanged; they are not
+// compared. Only the backward pass runs, unless another evaluation came between, that call failed, or the context
+// uses truncated BPTT, which overwrites the slabs as it goes: then the whole evaluation is rerun
+QUQEMATH_API int EvaluateGradient(TrainingContext* c, double* weights, int nWeights, double* gradient);
+
+// status of the last EvaluateWeights call, including the one that stopped a TrainSCG run
+QUQEMATH_API int GetEvaluationStatus(TrainingContext* c, EvaluationStatus* status);
+
+QUQEMATH_API void DestroyTrainingContext(void* context);
+
+QUQEMATH_API int GetEvaluationAllocationCount(TrainingContext* c);
+
+// Copies the context's stats to stats and returns 1, or returns 0 if stats were compiled out
+QUQEMATH_API int GetContextStats(TrainingContext* c, ContextStats* stats);
+QUQEMATH_API void ResetContextStats(TrainingContext* c);
+
+QUQEMATH_API void* CreateBatchTrainingContext(
+  LayerSpec* layerSpecs, int nLayers,
+  double* trainingData, double* outputData,
+  int nInputs, int nSamples,
+  int* windowOffsets, int nWindows, int windowLength);
+
+QUQEMATH_API void EvaluateWeightsBatch(BatchTrainingContext* c, double* weights, int nWeights,
+  double* outputs, double* errors, double* gradients);
+
+QUQEMATH_API void DestroyBatchTrainingContext(void* context);
+
+QUQEMATH_API int TrainSCG(TrainingContext* c, double* initialWeights, int nWeights, int epochMax, double tau,
+  volatile int* cancelFlag, double* finalWeights, double* costHistory);
+
+}
+
+extern "C" {
+
+QUQEMATH_API void* CreatePropagationContext(
+	LayerSpec* layerSpecs, int nLayers,
+	int nInputs,
+	double* weights, int nWeights);
+
+QUQEMATH_API void PropagateInput(PropagationContext* c, double* input, double* output);
+
+QUQEMATH_API void PropagateSequence(PropagationContext* c, double* inputs, int nInputs, int nSteps, double* outputs,
+  int ldInputs);
+
+// state buffers hold GetStateSize doubles
+QUQEMATH_API int GetStateSize(PropagationContext* c);
+QUQEMATH_API void SaveState(PropagationContext* c, double* state);
+QUQEMATH_API void RestoreState(PropagationContext* c, double* state);
+QUQEMATH_API void ResetState(PropagationContext* c);
+
+QUQEMATH_API void DestroyPropagationContext(void* context);
+
+}
+
+extern "C" {
+
+QUQEMATH_API void* CreateEnsembleContext(int nInputs, int maxMembers);
+
+// both return the new member's index
+QUQEMATH_API int AddRnnMember(EnsembleContext* c, int inputOffset, LayerSpec* layerSpecs, int nLayers, int nInputs,
+  double* weights, int nWeights);
+QUQEMATH_API int AddRbfMember(EnsembleContext* c, int inputOffset, int nInputs, double* centers, double* weights,
+  int nCenters, double outputBias, double spread, int isDegenerate);
+
+QUQEMATH_API void EnsemblePredict(EnsembleContext* c, double* inputs, int nSteps, int ldInputs,
+  double* memberOutputs, double* votes, int nThreads);
+QUQEMATH_API void ResetEnsembleState(EnsembleContext* c);
+
+// nThreads <= 0 uses one thread per hardware thread. callback may be NULL
+QUQEMATH_API void* CreateTrainingScheduler(int nThreads, TrainingJobCallback callback, void* callbackState);
+// Queues a TrainSCG run from initialWeights over timesteps [offset, offset + length) of data, and returns its job
+// number. Returns -1 instead if CreateTrainingContextOnDataSet would reject the window or the truncated BPTT
+// arguments, or nWeights doesn't fit the layers. Everything passed in is copied or referenced, so it may be freed
+// once this returns
+QUQEMATH_API int SubmitTrainingJob(TrainingScheduler* s, LayerSpec* layerSpecs, int nLayers, SharedDataSet* data,
+  int offset, int length, int precision, int bpttWindow, int bpttStride, double* initialWeights, int nWeights,
+  int epochMax, double tau);
+// Stops a job at its next epoch, or before it starts. job -1 cancels every job submitted so far
+QUQEMATH_API void CancelTrainingJob(TrainingScheduler* s, int job);
+// blocks until every job submitted so far has finished
+QUQEMATH_API void WaitForTrainingJobs(TrainingScheduler* s);
+// Returns -1 if the job hasn't finished, and -2 if there is no such job. Otherwise fills in what TrainSCG would have and returns the number of
+// costs written, which is 0 if the job was canceled before it started. costHistory needs epochMax + 1 entries
+QUQEMATH_API int GetTrainingJobResult(TrainingScheduler* s, int job, double* finalWeights, double* costHistory,
+  EvaluationStatus* status, double* seconds);
+// cancels whatever is left and waits for the threads to finish
+QUQEMATH_API void DestroyTrainingScheduler(void* s);
+
+QUQEMATH_API void DestroyEnsembleContext(void* context);
+
+}
+
+extern "C" {
+
+QUQEMATH_API void* CreateOrthoContext(int basisDimension, int maxBasisCount);
+QUQEMATH_API void DestroyOrthoContext(void* context);
+
+// basis must already be orthonormal to the others. Returns the new basis count
+QUQEMATH_API int AppendBasis(OrthoContext* c, double* basis);
+QUQEMATH_API int GetBasisCount(OrthoContext* c);
+QUQEMATH_API void ClearBases(OrthoContext* c);
+
+// replace p with its normalized component orthogonal to the context's bases
+QUQEMATH_API void Orthogonalize(OrthoContext* c, double* p);
+// the same for count vectors of length BasisDimension stored one after another
+QUQEMATH_API void OrthogonalizeMany(OrthoContext* c, double* candidates, int count);
+
+}
+
+extern "C" {
+
+QUQEMATH_API void GaussianKernelMatrix(double* centers, int m, int d, double* inputs, int n, int ldInputs,
+  double spread, double* k, int ldk);
+QUQEMATH_API void GaussianKernelMatrixF(double* centers, int m, int d, double* inputs, int n, int ldInputs,
+  double spread, float* k, int ldk);
+QUQEMATH_API void RbfPredict(double* centers, double* weights, int m, int d, double outputBias, double spread,
+  double* inputs, int n, int ldInputs, double* outputs);
+
+}
+
+extern "C" QUQEMATH_API int SelectOLSBases(double* candidates, int n, int m, double* y, double tolerance, int maxBases,
+  volatile int* cancelFlag, int* selected, double* weights);
+
+extern "C" QUQEMATH_API int GetWeightCount(LayerSpec* layerSpecs, int nLayers, int nInputs);
+
+// number of Vector/Matrix buffers the calling thread has allocated so far
+extern "C" QUQEMATH_API int GetThreadAllocationCount();
+
+extern "C" {
+
+QUQEMATH_API int GetActivationKernel();
+QUQEMATH_API int ApplyLogisticSigmoid(double* x, double* y, int n, int kernel);
+QUQEMATH_API int ApplyExp(double* x, double* y, int n, int kernel);
+
+}
+
+// y[i] = LogisticSigmoid(x[i]) using the widest kernel this CPU supports. x and y may alias. Returns whether
+// every x[i] was finite
+bool LogisticSigmoidVector(double* x, double* y, int n);
+bool LogisticSigmoidVector(float* x, float* y, int n);
+// y[i] = exp(x[i]), likewise
+bool ExpVector(double* x, double* y, int n);
+bool ExpVector(float* x, float* y, int n);
+
+// x - x is 0 for finite x and NaN for infinities and NaNs. The flags are combined with an integer AND, so the
+// loop vectorizes without relaxing floating point semantics
+template <typename T>
+inline bool AllFinite(const T* x, int n)
+{
+  int finite = 1;
+  for (int i = 0; i < n; i++)
+    finite &= x[i] - x[i] == 0;
+  return finite != 0;
+}
+
+// the templates below are instantiated for float and double
+template <typename T>
+void DeleteLayers(LayerT<T>** layers, int nLayers, bool deleteWeights);
+
+void Propagate(double* input, int inputStride, int numLayers, Layer** currLayers, Layer** prevLayers,
+  Vector* timeZeroRecurrentInput);
+template <typename T>
+void PropagateLayer(T* input, int inputStride, LayerT<T>* layer, T* recurrentInput, T* a, T* z);
+
+// z = the layer's activation function of a, for n values (any number of rows of the layer). Returns whether
+// every a was finite
+template <typename T>
+inline bool ActivateLayer(LayerT<T>* layer, T* a, T* z, int n)
+{
+  if (layer->ActivationType == ACTIVATION_LOGSIG)
+    return LogisticSigmoidVector(a, z, n);
+  // ACTIVATION_PURELIN
+  memcpy(z, a, n * sizeof(T));
+  return AllFinite(a, n);
+}
+
+template <typename T>
+LayerT<T>** SpecsToLayers(int numInputs, LayerSpec* specs, int numLayers);
+template <typename T>
+LayerT<T>** SpecsToLayerViews(int numInputs, LayerSpec* specs, int numLayers, T* weights);
+template <typename T>
+void BindLayerViews(LayerT<T>** layers, int numLayers, T* weights);
+template <typename T>
+VectorT<T>* MakeTimeZeroRecurrentInput(int size);
+
+// weights are always double; float layers get them rounded
+template <typename T>
+void SetWeights(LayerT<T>** layers, int numLayers, double* weights, int nWeights);
+template <typename T>
+double* SetVectorWeights(VectorT<T>* v, double* weights);
+template <typename T>
+double* SetMatrixWeights(MatrixT<T>* m, double* weights);
+
+int GetWeights(Layer** layers, int numLayers, double* weights, int nWeights);
+double* GetVectorWeights(Vector* v, double* weights);
+double* GetMatrixWeights(Matrix* m, double* weights);
+
+double Linear(double x);
+double LinearPrime(double x);
+double LogisticSigmoidPrime(double x);
+
+inline double Linear(double x)
+{
+  return x;
+}
+
+inline double LinearPrime(double x)
+{
+  return 1;
+}
+
+//#define LogisticSigmoid(x)    (1 / (1 + exp(-(x))))
+
+inline double LogisticSigmoid(double x)
+{
+  // without this, exp(-x) can overflow, but the FPU handles it ok: 1 / (1 + INF) == 0
+  //static const double xmin = -log(DBL_MAX-1);
+  //if (x <= xmin)
+  //  return 0;
+
+  return 1.0 / (1.0 + exp(-x));
+}
+
+inline double LogisticSigmoidPrime(double x)
+{
+  double v = LogisticSigmoid(x);
+  return v * (1 - v);
 }
\ No newline at end of file
@@ -0,0 +1,138 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+// Gaussian RBF kernel matrices: K[j][i] = exp(-|c_j - x_i|^2 / spread^2) for m centers c_j, the rows of a
+// row-major m x d matrix, and n inputs x_i, the columns of a row-major d x n matrix with rows ldInputs apart
+// (0 means n). |c - x|^2 is expanded as |c|^2 + |x|^2 - 2 c.x so that all the cross terms of a tile come from
+// one dgemm. When c and x nearly coincide rounding can leave the expansion slightly negative; it is clamped to 0.
+// K is built a tile at a time so the tile is still in cache when exp runs over it.
+
+static const int KernelTileRows = 64;
+static const int KernelTileColumns = 256;
+
+static void CenterNorms(double* centers, int m, int d, double* norms)
+{
+	for (int j = 0; j < m; j++)
+		norms[j] = cblas_ddot(d, centers + j * d, 1, centers + j * d, 1);
+}
+
+static void InputNorms(double* inputs, int d, int ldInputs, int cols, double* norms)
+{
+	for (int i = 0; i < cols; i++)
+		norms[i] = 0;
+	for (int r = 0; r < d; r++)
+	{
+		double* x = inputs + r * ldInputs;
+		for (int i = 0; i < cols; i++)
+			norms[i] += x[i] * x[i];
+	}
+}
+
+// tile[j][i] = -|c_j - x_i|^2 / spread^2 for a rows x cols tile
+static void KernelExponents(double* centers, double* centerNorms, int rows, int d, double* inputs, int ldInputs,
+	double* inputNorms, int cols, double spread, double* tile, int ldTile)
+{
+	double scale = 1 / (spread * spread);
+	BlasGemm(CblasNoTrans, CblasNoTrans, rows, cols, d, 2 * scale, centers, d, inputs, ldInputs, 0.0, tile, ldTile);
+	for (int j = 0; j < rows; j++)
+	{
+		double* t = tile + j * ldTile;
+		double cn = centerNorms[j];
+		for (int i = 0; i < cols; i++)
+		{
+			double e = t[i] - (cn + inputNorms[i]) * scale;
+			t[i] = e < 0 ? e : 0;
+		}
+	}
+}
+
+template <typename T>
+static void GaussianKernel(double* centers, int m, int d, double* inputs, int n, int ldInputs, double spread,
+	T* k, int ldk)
+{
+	if (ldInputs == 0)
+		ldInputs = n;
+	if (ldk == 0)
+		ldk = n;
+	int tileRows = m < KernelTileRows ? m : KernelTileRows;
+	int tileColumns = n < KernelTileColumns ? n : KernelTileColumns;
+	Vector* centerNorms = new Vector(m);
+	Vector* inputNorms = new Vector(tileColumns);
+	Matrix* tile = new Matrix(tileRows, tileColumns);
+	CenterNorms(centers, m, d, centerNorms->Data);
+
+	for (int i0 = 0; i0 < n; i0 += tileColumns)
+	{
+		int cols = n - i0 < tileColumns ? n - i0 : tileColumns;
+		InputNorms(inputs + i0, d, ldInputs, cols, inputNorms->Data);
+		for (int j0 = 0; j0 < m; j0 += tileRows)
+		{
+			int rows = m - j0 < tileRows ? m - j0 : tileRows;
+			KernelExponents(centers + j0 * d, centerNorms->Data + j0, rows, d, inputs + i0, ldInputs,
+				inputNorms->Data, cols, spread, tile->Data, tileColumns);
+			for (int j = 0; j < rows; j++)
+			{
+				T* kRow = k + (j0 + j) * ldk + i0;
+				ConvertCopy(kRow, GetRowPtr(tile, j), cols);
+				ExpVector(kRow, kRow, cols);
+			}
+		}
+	}
+
+	delete centerNorms;
+	delete inputNorms;
+	delete tile;
+}
+
+// Writes the m x n kernel matrix to k, whose rows are ldk apart (0 means n). A block of a larger kernel matrix
+// can be built by passing a range of centers and inputs, with k pointing at the block and ldk the full width
+QUQEMATH_API void GaussianKernelMatrix(double* centers, int m, int d, double* inputs, int n, int ldInputs,
+	double spread, double* k, int ldk)
+{
+	GaussianKernel(centers, m, d, inputs, n, ldInputs, spread, k, ldk);
+}
+
+// the same in float. The exponents are still computed in double, since the expansion loses too much to
+// cancellation in float; only the exp and the result are float
+QUQEMATH_API void GaussianKernelMatrixF(double* centers, int m, int d, double* inputs, int n, int ldInputs,
+	double spread, float* k, int ldk)
+{
+	GaussianKernel(centers, m, d, inputs, n, ldInputs, spread, k, ldk);
+}
+
+// outputs[i] = outputBias + sum_j weights[j] K[j][i], an RBF network's prediction for each of the n inputs
+QUQEMATH_API void RbfPredict(double* centers, double* weights, int m, int d, double outputBias, double spread,
+	double* inputs, int n, int ldInputs, double* outputs)
+{
+	if (ldInputs == 0)
+		ldInputs = n;
+	int tileRows = m < KernelTileRows ? m : KernelTileRows;
+	int tileColumns = n < KernelTileColumns ? n : KernelTileColumns;
+	Vector* centerNorms = new Vector(m);
+	Vector* inputNorms = new Vector(tileColumns);
+	Matrix* tile = new Matrix(tileRows, tileColumns);
+	CenterNorms(centers, m, d, centerNorms->Data);
+
+	for (int i = 0; i < n; i++)
+		outputs[i] = outputBias;
+	for (int i0 = 0; i0 < n; i0 += tileColumns)
+	{
+		int cols = n - i0 < tileColumns ? n - i0 : tileColumns;
+		InputNorms(inputs + i0, d, ldInputs, cols, inputNorms->Data);
+		for (int j0 = 0; j0 < m; j0 += tileRows)
+		{
+			int rows = m - j0 < tileRows ? m - j0 : tileRows;
+			KernelExponents(centers + j0 * d, centerNorms->Data + j0, rows, d, inputs + i0, ldInputs,
+				inputNorms->Data, cols, spread, tile->Data, tileColumns);
+			for (int j = 0; j < rows; j++)
+				ExpVector(GetRowPtr(tile, j), GetRowPtr(tile, j), cols);
+			BlasGemv(CblasTrans, rows, cols, 1.0, tile->Data, tileColumns, weights + j0, 1, 1.0, outputs + i0, 1);
+		}
+	}
+
+	delete centerNorms;
+	delete inputNorms;
+	delete tile;
+}
@@ -0,0 +1,235 @@
+#include "stdafx.h"
+#include "LinReg.h"
+
+// Plain C++ implementation of the CBLAS routines QuqeMath calls, used when building with
+// QUQEMATH_BLAS=Reference. It favors being obviously correct over being fast, and is meant for
+// checking results on machines without a tuned BLAS, not for training runs.
+// Row-major calls are mapped to column-major ones on the transposed problem.
+
+static inline bool IsTrans(enum CBLAS_TRANSPOSE trans)
+{
+	return trans == CblasTrans || trans == CblasConjTrans;
+}
+
+static inline enum CBLAS_TRANSPOSE Flip(enum CBLAS_TRANSPOSE trans)
+{
+	return IsTrans(trans) ? CblasNoTrans : CblasTrans;
+}
+
+// start of a strided vector, per the BLAS convention for negative increments
+#define VecStart(x,n,inc)    ((inc) < 0 ? (x) - ((n) - 1) * (inc) : (x))
+
+double cblas_ddot(blasint n, double* x, blasint incx, double* y, blasint incy)
+{
+	x = VecStart(x, n, incx);
+	y = VecStart(y, n, incy);
+	double sum = 0;
+	for (int i = 0; i < n; i++)
+		sum += x[i * incx] * y[i * incy];
+	return sum;
+}
+
+double cblas_dnrm2(blasint n, double* x, blasint incx)
+{
+	if (n <= 0 || incx <= 0)
+		return 0;
+	// scaled to avoid overflow, as in the reference Fortran dnrm2
+	double scale = 0;
+	double ssq = 1;
+	for (int i = 0; i < n; i++)
+	{
+		double v = fabs(x[i * incx]);
+		if (v == 0)
+			continue;
+		if (scale < v)
+		{
+			ssq = 1 + ssq * (scale / v) * (scale / v);
+			scale = v;
+		}
+		else
+			ssq += (v / scale) * (v / scale);
+	}
+	return scale * sqrt(ssq);
+}
+
+// index of the first element of largest magnitude
+CBLAS_INDEX cblas_idamax(blasint n, double* x, blasint incx)
+{
+	if (n <= 0 || incx <= 0)
+		return 0;
+	CBLAS_INDEX best = 0;
+	double bestValue = fabs(x[0]);
+	for (int i = 1; i < n; i++)
+	{
+		double v = fabs(x[i * incx]);
+		if (v > bestValue)
+		{
+			best = i;
+			bestValue = v;
+		}
+	}
+	return best;
+}
+
+void cblas_daxpy(blasint n, double alpha, double* x, blasint incx, double* y, blasint incy)
+{
+	if (alpha == 0)
+		return;
+	x = VecStart(x, n, incx);
+	y = VecStart(y, n, incy);
+	for (int i = 0; i < n; i++)
+		y[i * incy] += alpha * x[i * incx];
+}
+
+template <typename T>
+static void Copy(blasint n, T* x, blasint incx, T* y, blasint incy)
+{
+	x = VecStart(x, n, incx);
+	y = VecStart(y, n, incy);
+	for (int i = 0; i < n; i++)
+		y[i * incy] = x[i * incx];
+}
+
+void cblas_dcopy(blasint n, double* x, blasint incx, double* y, blasint incy)
+{
+	Copy(n, x, incx, y, incy);
+}
+
+void cblas_scopy(blasint n, float* x, blasint incx, float* y, blasint incy)
+{
+	Copy(n, x, incx, y, incy);
+}
+
+void cblas_dscal(blasint n, double alpha, double* x, blasint incx)
+{
+	if (incx <= 0)
+		return;
+	for (int i = 0; i < n; i++)
+		x[i * incx] *= alpha;
+}
+
+template <typename T>
+static void ColMajorGEMV(enum CBLAS_TRANSPOSE trans, int m, int n, T alpha, T* a, int lda,
+	T* x, int incx, T beta, T* y, int incy)
+{
+	int lenX = IsTrans(trans) ? m : n;
+	int lenY = IsTrans(trans) ? n : m;
+	x = VecStart(x, lenX, incx);
+	y = VecStart(y, lenY, incy);
+
+	for (int i = 0; i < lenY; i++)
+		y[i * incy] = beta == 0 ? 0 : beta * y[i * incy];
+	if (alpha == 0)
+		return;
+
+	if (!IsTrans(trans))
+	{
+		for (int j = 0; j < n; j++)
+		{
+			T t = alpha * x[j * incx];
+			T* col = a + j * lda;
+			for (int i = 0; i < m; i++)
+				y[i * incy] += t * col[i];
+		}
+	}
+	else
+	{
+		for (int j = 0; j < n; j++)
+		{
+			T* col = a + j * lda;
+			T sum = 0;
+			for (int i = 0; i < m; i++)
+				sum += col[i] * x[i * incx];
+			y[j * incy] += alpha * sum;
+		}
+	}
+}
+
+void cblas_dgemv(enum CBLAS_ORDER order, enum CBLAS_TRANSPOSE trans, blasint m, blasint n,
+	double alpha, double* a, blasint lda, double* x, blasint incx, double beta, double* y, blasint incy)
+{
+	if (order == CblasColMajor)
+		ColMajorGEMV(trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+	else
+		ColMajorGEMV(Flip(trans), n, m, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+void cblas_sgemv(enum CBLAS_ORDER order, enum CBLAS_TRANSPOSE trans, blasint m, blasint n,
+	float alpha, float* a, blasint lda, float* x, blasint incx, float beta, float* y, blasint incy)
+{
+	if (order == CblasColMajor)
+		ColMajorGEMV(trans, m, n, alpha, a, lda, x, incx, beta, y, incy);
+	else
+		ColMajorGEMV(Flip(trans), n, m, alpha, a, lda, x, incx, beta, y, incy);
+}
+
+static void ColMajorGER(int m, int n, double alpha, double* x, int incx, double* y, int incy, double* a, int lda)
+{
+	x = VecStart(x, m, incx);
+	y = VecStart(y, n, incy);
+	for (int j = 0; j < n; j++)
+	{
+		double t = alpha * y[j * incy];
+		double* col = a + j * lda;
+		for (int i = 0; i < m; i++)
+			col[i] += x[i * incx] * t;
+	}
+}
+
+void cblas_dger(enum CBLAS_ORDER order, blasint m, blasint n, double alpha, double* x, blasint incx,
+	double* y, blasint incy, double* a, blasint lda)
+{
+	if (order == CblasColMajor)
+		ColMajorGER(m, n, alpha, x, incx, y, incy, a, lda);
+	else
+		ColMajorGER(n, m, alpha, y, incy, x, incx, a, lda);
+}
+
+template <typename T>
+static void ColMajorGEMM(enum CBLAS_TRANSPOSE transA, enum CBLAS_TRANSPOSE transB, int m, int n, int k,
+	T alpha, T* a, int lda, T* b, int ldb, T beta, T* c, int ldc)
+{
+	bool ta = IsTrans(transA);
+	bool tb = IsTrans(transB);
+	for (int j = 0; j < n; j++)
+	{
+		T* cj = c + j * ldc;
+		for (int i = 0; i < m; i++)
+			cj[i] = beta == 0 ? 0 : beta * cj[i];
+		if (alpha == 0)
+			continue;
+		for (int p = 0; p < k; p++)
+		{
+			T bpj = alpha * (tb ? b[j + p * ldb] : b[p + j * ldb]);
+			if (!ta)
+			{
+				T* ap = a + p * lda;
+				for (int i = 0; i < m; i++)
+					cj[i] += ap[i] * bpj;
+			}
+			else
+			{
+				for (int i = 0; i < m; i++)
+					cj[i] += a[p + i * lda] * bpj;
+			}
+		}
+	}
+}
+
+void cblas_dgemm(enum CBLAS_ORDER order, enum CBLAS_TRANSPOSE transA, enum CBLAS_TRANSPOSE transB, blasint m, blasint n, blasint k,
+	double alpha, double* a, blasint lda, double* b, blasint ldb, double beta, double* c, blasint ldc)
+{
+	if (order == CblasColMajor)
+		ColMajorGEMM(transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+	else // C' = op(B)' op(A)'
+		ColMajorGEMM(transB, transA, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+}
+
+void cblas_sgemm(enum CBLAS_ORDER order, enum CBLAS_TRANSPOSE transA, enum CBLAS_TRANSPOSE transB, blasint m, blasint n, blasint k,
+	float alpha, float* a, blasint lda, float* b, blasint ldb, float beta, float* c, blasint ldc)
+{
+	if (order == CblasColMajor)
+		ColMajorGEMM(transA, transB, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+	else
+		ColMajorGEMM(transB, transA, n, m, k, alpha, b, ldb, a, lda, beta, c, ldc);
+}
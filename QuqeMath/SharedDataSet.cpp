@@ -0,0 +1,68 @@
+#include "stdafx.h"
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+SharedDataSet::SharedDataSet(double* trainingData, double* outputData, int nInputs, int nSamples)
+	: RefCount(1)
+{
+	NumInputs = nInputs;
+	NumSamples = nSamples;
+
+	// trainingData is nInputs x nSamples with one sample per column
+	Inputs = new Matrix(nSamples, nInputs);
+	for (int i = 0; i < nInputs; i++)
+		cblas_dcopy(nSamples, trainingData + i * nSamples, 1, GetColumnPtr(Inputs, i), nInputs);
+	Outputs = new Vector(nSamples, outputData);
+	InputsF = NULL;
+	OutputsF = NULL;
+}
+
+SharedDataSet::~SharedDataSet()
+{
+	delete Inputs;
+	delete Outputs;
+	delete InputsF;
+	delete OutputsF;
+}
+
+void SharedDataSet::AddRef()
+{
+	RefCount++;
+}
+
+void SharedDataSet::Release()
+{
+	if (--RefCount == 0)
+		delete this;
+}
+
+// contexts may be created on several threads at once, so the copies are made under call_once
+static void MakeSingleCopies(Matrix* inputs, Vector* outputs, MatrixT<float>** inputsF, VectorT<float>** outputsF)
+{
+	*inputsF = new MatrixT<float>(inputs->RowCount, inputs->ColumnCount);
+	ConvertCopy((*inputsF)->Data, inputs->Data, inputs->DataLen);
+	*outputsF = new VectorT<float>(outputs->Count);
+	ConvertCopy((*outputsF)->Data, outputs->Data, outputs->Count);
+}
+
+MatrixT<float>* SharedDataSet::GetInputsF()
+{
+	std::call_once(SingleCopyOnce, MakeSingleCopies, Inputs, Outputs, &InputsF, &OutputsF);
+	return InputsF;
+}
+
+VectorT<float>* SharedDataSet::GetOutputsF()
+{
+	std::call_once(SingleCopyOnce, MakeSingleCopies, Inputs, Outputs, &InputsF, &OutputsF);
+	return OutputsF;
+}
+
+QUQEMATH_API void* CreateDataSet(double* trainingData, double* outputData, int nInputs, int nSamples)
+{
+	return new SharedDataSet(trainingData, outputData, nInputs, nSamples);
+}
+
+QUQEMATH_API void ReleaseDataSet(SharedDataSet* data)
+{
+	data->Release();
+}
@@ -0,0 +1,90 @@
+#include "stdafx.h"
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+// Matrix-vector products for the per-timestep recurrences, specialized on the matrix's column count K, which
+// is a layer's node count. At the layer sizes chromosomes use, a BLAS gemv call costs more in argument checking
+// and dispatch than in arithmetic; with K known the loops below unroll completely and the compiler vectorizes
+// them. The sums are accumulated in a different order than BLAS would, so results differ from it by rounding.
+
+// y[i] += W[i] . x for the m rows of W. Each row is summed in four independent partial sums so the compiler
+// can vectorize across them without reassociating
+template <typename T, int K>
+static void SmallGemv(const T* w, const T* x, T* y, int m)
+{
+	for (int i = 0; i < m; i++)
+	{
+		const T* wi = w + i * K;
+		T s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+		int k = 0;
+		for (; k + 4 <= K; k += 4)
+		{
+			s0 += wi[k] * x[k];
+			s1 += wi[k + 1] * x[k + 1];
+			s2 += wi[k + 2] * x[k + 2];
+			s3 += wi[k + 3] * x[k + 3];
+		}
+		for (; k < K; k++)
+			s0 += wi[k] * x[k];
+		y[i] += (s0 + s1) + (s2 + s3);
+	}
+}
+
+// y = W' x, or y += W' x if accumulate, for W with m rows: one axpy of length K per row. Accumulating into y
+// rather than a local array keeps the compiler vectorizing along the rows instead of across them
+template <typename T, int K>
+static void SmallGemvT(const T* w, const T* x, T* y, int m, bool accumulate)
+{
+	if (!accumulate)
+		for (int k = 0; k < K; k++)
+			y[k] = 0;
+	for (int i = 0; i < m; i++)
+	{
+		const T* wi = w + i * K;
+		T xi = x[i];
+		for (int k = 0; k < K; k++)
+			y[k] += wi[k] * xi;
+	}
+}
+
+// fills table[1..K] with the kernels for each column count
+template <typename T, int K>
+struct SmallKernelTable
+{
+	static void Fill(SmallKernels<T>* table)
+	{
+		table[K].Gemv = SmallGemv<T, K>;
+		table[K].GemvT = SmallGemvT<T, K>;
+		SmallKernelTable<T, K - 1>::Fill(table);
+	}
+};
+
+template <typename T>
+struct SmallKernelTable<T, 0>
+{
+	static void Fill(SmallKernels<T>* table)
+	{
+		table[0].Gemv = NULL;
+		table[0].GemvT = NULL;
+	}
+};
+
+template <typename T>
+static SmallKernels<T>* MakeSmallKernelTable()
+{
+	static SmallKernels<T> table[SmallKernelMaxColumns + 1];
+	SmallKernelTable<T, SmallKernelMaxColumns>::Fill(table);
+	return table;
+}
+
+template <typename T>
+SmallKernels<T> GetSmallKernels(int columnCount)
+{
+	static SmallKernels<T>* table = MakeSmallKernelTable<T>();
+	if (columnCount > SmallKernelMaxColumns)
+		return table[0];
+	return table[columnCount];
+}
+
+template SmallKernels<double> GetSmallKernels<double>(int columnCount);
+template SmallKernels<float> GetSmallKernels<float>(int columnCount);
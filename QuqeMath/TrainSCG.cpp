@@ -0,0 +1,189 @@
+#include "stdafx.h"
+#include <stdio.h>
+#include <float.h>
+#include <limits>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+#define DOT(x,y,n)    (cblas_ddot((n), (x), 1, (y), 1))
+
+static inline void Swap(double*& a, double*& b)
+{
+	double* tmp = a;
+	a = b;
+	b = tmp;
+}
+
+// Scaled Conjugate Gradient algorithm from Williams (1991).
+// Mirrors the managed implementation that used to live in RNNTrain.cs, but keeps every
+// vector in buffers allocated once up front so an epoch does no allocation at all.
+// costHistory must have room for epochMax + 1 entries. Returns the number of entries written.
+// Stops as soon as an evaluation finds a non-finite value (GetEvaluationStatus says where), leaving finalWeights
+// at the last weights that evaluated cleanly. If the initial weights fail, the one cost written is NaN.
+QUQEMATH_API int TrainSCG(TrainingContext* c, double* initialWeights, int nWeights, int epochMax, double tau,
+	volatile int* cancelFlag, double* finalWeights, double* costHistory)
+{
+	int n = nWeights;
+	const int numBuffers = 7;
+	Vector* buffers[numBuffers];
+	for (int i = 0; i < numBuffers; i++)
+		buffers[i] = new Vector(n);
+	double* w = buffers[0]->Data;
+	double* w1 = buffers[1]->Data;  // also holds w + alpha*s while probing
+	double* g = buffers[2]->Data;
+	double* g1 = buffers[3]->Data;
+	double* s = buffers[4]->Data;
+	double* tmp = buffers[5]->Data; // w + sigma*s, also scratch
+	double* tmpGrad = buffers[6]->Data;
+	Vector* output = new Vector(c->LayerSpecs[c->NumLayers-1].NodeCount);
+
+	double lambda_min = std::numeric_limits<double>::denorm_min();
+	double lambda_max = DBL_MAX;
+	int S_max = n;
+	bool resumable = c->BpttWindow == 0; // whether an EvaluateError can be finished by EvaluateGradient
+
+	// 0. initialize variables
+	memcpy(w, initialWeights, n * sizeof(double));
+	double epsilon = 1e-3;
+	double lambda = 1;
+	double pi = 0.05;
+
+	double errAtW;
+	bool diverged = EvaluateWeights(c, w, n, output->Data, &errAtW, g) != EVAL_OK;
+	int numCosts = 0;
+	costHistory[numCosts++] = errAtW;
+
+	// s = -g
+	memcpy(s, g, n * sizeof(double));
+	cblas_dscal(n, -1, s, 1);
+	bool success = true;
+	int S = 0;
+
+	double kappa = 0; // will be assigned in (1) on first iteration
+	double sigma = 0; // will be assigned in (1) on first iteration
+	double gamma = 0; // will be assigned in (1) on first iteration
+	double mu = 0;    // will be assigned in (1) on first iteration
+	int epoch = 0;
+	while (!diverged)
+	{
+		// 1. if success == true, calculate first and second order directional derivatives
+		if (success)
+		{
+			mu = DOT(s, g, n); // (directional gradient)
+			if (mu >= 0)
+			{
+				memcpy(s, g, n * sizeof(double));
+				cblas_dscal(n, -1, s, 1);
+				mu = DOT(s, g, n);
+				S = 0;
+			}
+			kappa = DOT(s, s, n);
+			sigma = epsilon / sqrt(kappa);
+
+			// approximate curvature: (gradient(w + sigma*s) - g) / sigma
+			memcpy(tmp, w, n * sizeof(double));
+			cblas_daxpy(n, sigma, s, 1, tmp, 1);
+			double errAtTmp;
+			if (EvaluateWeights(c, tmp, n, output->Data, &errAtTmp, tmpGrad) != EVAL_OK)
+				break;
+			cblas_daxpy(n, -1, g, 1, tmpGrad, 1);
+			cblas_dscal(n, 1 / sigma, tmpGrad, 1);
+			gamma = DOT(s, tmpGrad, n); // (directional curvature)
+		}
+
+		// 2. increase the working curvature
+		double delta = gamma + lambda * kappa;
+
+		// 3. if delta <= 0, make delta positive and increase lambda
+		if (delta <= 0)
+		{
+			delta = lambda * kappa;
+			lambda = lambda - gamma / kappa;
+		}
+
+		// 4. calculate step size and adapt epsilon
+		double alpha = -mu / delta;
+		double epsilon1 = epsilon * pow(alpha / sigma, pi);
+
+		// 5. calculate the comparison ratio. Only the error is needed unless the step succeeds, and then the
+		// context still holds the forward pass, so the gradient costs just the backward pass. Truncated BPTT
+		// can't resume like that, so there the gradient is computed up front
+		memcpy(w1, w, n * sizeof(double));
+		cblas_daxpy(n, alpha, s, 1, w1, 1);
+		double errAtW1;
+		int status = resumable ? EvaluateError(c, w1, n, output->Data, &errAtW1)
+			: EvaluateWeights(c, w1, n, output->Data, &errAtW1, g1);
+		if (status != EVAL_OK)
+			break;
+		double rho = 2 * (errAtW1 - errAtW) / (alpha * mu);
+		success = rho >= 0;
+		if (success && resumable && EvaluateGradient(c, w1, n, g1) != EVAL_OK)
+			break;
+
+		// 6. revise lambda
+		double lambda1;
+		if (rho < 0.25)
+		{
+			lambda1 = lambda + delta * (1 - rho) / kappa;
+			if (lambda1 > lambda_max)
+				lambda1 = lambda_max;
+		}
+		else if (rho > 0.75)
+		{
+			lambda1 = lambda / 2;
+			if (lambda1 < lambda_min)
+				lambda1 = lambda_min;
+		}
+		else
+			lambda1 = lambda;
+
+		// 7. if success == true, adjust weights.
+		// w1 and g1 already hold w + alpha*s and its gradient from (5); otherwise w and g carry over
+		if (success)
+			S++;
+		else
+			errAtW1 = errAtW;
+		double* gNew = success ? g1 : g;
+
+		// 8. choose the new search direction
+		if (S == S_max || (S >= 2 && DOT(g, gNew, n) >= 0.2 * DOT(gNew, gNew, n))) // Powell-Beale restarts
+		{
+			memcpy(s, gNew, n * sizeof(double));
+			cblas_dscal(n, -1, s, 1);
+			success = true;
+			S = 0;
+		}
+		else if (success) // create new conjugate direction
+		{
+			// beta = (g - g1).g1 / mu
+			memcpy(tmp, g, n * sizeof(double));
+			cblas_daxpy(n, -1, g1, 1, tmp, 1);
+			double beta = DOT(tmp, g1, n) / mu;
+			cblas_dscal(n, beta, s, 1);
+			cblas_daxpy(n, -1, g1, 1, s, 1);
+		}
+		// else use current direction again. mu, kappa, sigma, and gamma stay the same
+
+		// 9. check tolerance and keep iterating if we're not there yet
+		epsilon = epsilon1;
+		lambda = lambda1;
+		errAtW = errAtW1;
+		costHistory[numCosts++] = errAtW;
+		if (gNew == g1)
+		{
+			Swap(g, g1);
+			Swap(w, w1);
+		}
+
+		epoch++;
+		bool done = epoch == epochMax || (epoch > 10 && cblas_dnrm2(n, g, 1) < tau);
+		if (done || (cancelFlag != NULL && *cancelFlag))
+			break;
+	}
+
+	memcpy(finalWeights, w, n * sizeof(double));
+	delete output;
+	for (int i = 0; i < numBuffers; i++)
+		delete buffers[i];
+	return numCosts;
+}
@@ -1,41 +1,186 @@
-#include "stdafx.h"
-#include <stdio.h>
-#include "QuqeMath.h"
-#include "LinReg.h"
-
-TrainingContext::TrainingContext(const Matrix &trainingInput, const Vector &trainingOutput, int nFrames, Frame** frames, int nLayers,
-																 LayerSpec* specs)
-{
-	TrainingInput = new Matrix(trainingInput);
-	TrainingOutput = new Vector(trainingOutput);
-	NumFrames = nFrames;
-	Frames = frames;
-	NumLayers = nLayers;
-	LayerSpecs = new LayerSpec[nLayers];
-	memcpy(LayerSpecs, specs, nLayers * sizeof(LayerSpec));
-}
-
-TrainingContext::~TrainingContext()
-{
-	DeleteFrames(Frames, TrainingInput->ColumnCount);
-	delete [] LayerSpecs;
-	delete TrainingInput;
-	delete TrainingOutput;
-}
-
-QUQEMATH_API void* CreateTrainingContext(
-	LayerSpec* layerSpecs, int nLayers,
-	double* trainingData, double* outputData,
-	int nInputs, int nSamples)
-{
-	Layer** protoLayers = SpecsToLayers(nInputs, layerSpecs, nLayers);
-	Frame** frames = LayersToFrames(protoLayers, nLayers, nSamples);
-	DeleteLayers(protoLayers, nLayers, false);
-	TrainingContext* context = new TrainingContext(Matrix(nInputs, nSamples, trainingData), Vector(nSamples, outputData), nSamples, frames, nLayers, layerSpecs);
-	return context;
-}
-
-QUQEMATH_API void DestroyTrainingContext(void* context)
-{
-	delete ((TrainingContext*)context);
+#include "stdafx.h"
+#include <stdio.h>
+#include "QuqeMath.h"
+#include "LinReg.h"
+#include "PhaseTimer.h"
+
+// Activations are stored per layer as one NumSamples x NodeCount slab, so a layer's values at time t
+// are one contiguous row, and the previous timestep's outputs (the recurrent input) are the row before it.
+// A layer's input at time t is the same row of the previous layer's Z slab, or of Inputs for the first layer.
+// With truncated BPTT the slabs only hold the current window and the timestep before it, and slide along
+// the sequence; Inputs always covers the whole sequence. Inputs and TrainingOutput are not copied: they point
+// into the context's SharedDataSet, which contexts over different windows of the same data share.
+// The layers' weight matrices are views into one flat weight vector in the SetWeights layout: Weights if the
+// buffers own their weights, which are a rounded copy of the caller's, else the caller's own, bound per call.
+
+template <typename T>
+TrainingBuffers<T>::TrainingBuffers(LayerSpec* specs, int nLayers, bool ownsWeights, T* inputs, T* trainingOutput,
+	int nInputs, int slabRows, int gradientBlockLength)
+{
+	NumLayers = nLayers;
+	NumInputs = nInputs;
+	Weights = ownsWeights ? new VectorT<T>(GetWeightCount(specs, nLayers, nInputs)) : NULL;
+	Layers = SpecsToLayerViews<T>(nInputs, specs, nLayers, ownsWeights ? Weights->Data : NULL);
+	Inputs = inputs;
+	TrainingOutput = trainingOutput;
+
+	SlabRows = slabRows;
+	A = new MatrixT<T>*[nLayers];
+	Z = new MatrixT<T>*[nLayers];
+	D = new MatrixT<T>*[nLayers];
+	Kernels = new SmallKernels<T>[nLayers];
+	int maxNodeCount = 0;
+	for (int l = 0; l < nLayers; l++)
+	{
+		int nodeCount = specs[l].NodeCount;
+		Kernels[l] = GetSmallKernels<T>(nodeCount);
+		A[l] = new MatrixT<T>(slabRows, nodeCount);
+		Z[l] = new MatrixT<T>(slabRows, nodeCount);
+		D[l] = new MatrixT<T>(slabRows, nodeCount);
+		if (nodeCount > maxNodeCount)
+			maxNodeCount = nodeCount;
+	}
+	Ones = new VectorT<T>(slabRows);
+	for (int t = 0; t < slabRows; t++)
+		Ones->Data[t] = 1;
+	TimeZeroRecurrentInput = MakeTimeZeroRecurrentInput<T>(maxNodeCount);
+	GradientBlockLength = gradientBlockLength;
+	GradientBlock = NULL;
+}
+
+template <typename T>
+TrainingBuffers<T>::~TrainingBuffers()
+{
+	for (int l = 0; l < NumLayers; l++)
+	{
+		delete A[l];
+		delete Z[l];
+		delete D[l];
+	}
+	delete [] A;
+	delete [] Z;
+	delete [] D;
+	delete [] Kernels;
+	DeleteLayers(Layers, NumLayers, true);
+	delete Weights;
+	delete Ones;
+	delete TimeZeroRecurrentInput;
+	delete GradientBlock;
+}
+
+template class TrainingBuffers<double>;
+template class TrainingBuffers<float>;
+
+TrainingContext::TrainingContext(LayerSpec* specs, int nLayers, SharedDataSet* data, int offset, int length,
+	int precision, int bpttWindow, int bpttStride)
+{
+	assert(ValidBpttArguments(bpttWindow, bpttStride));
+	assert(ValidDataWindow(data, offset, length));
+	memset(&Stats, 0, sizeof(Stats));
+	int allocationsBefore = ThreadAllocationCount;
+	long long bytesBefore = ThreadAllocatedBytes;
+	TIME_PHASE(&Stats, PHASE_SETUP, 0);
+	int nInputs = data->NumInputs;
+	NumSamples = length;
+	NumInputs = nInputs;
+	NumLayers = nLayers;
+	LayerSpecs = new LayerSpec[nLayers];
+	memcpy(LayerSpecs, specs, nLayers * sizeof(LayerSpec));
+	Data = data;
+	Data->AddRef();
+	DataOffset = offset;
+	Precision = precision;
+	BpttWindow = bpttWindow < length ? bpttWindow : length;
+	BpttStride = bpttStride < BpttWindow ? bpttStride : BpttWindow;
+	Double = NULL;
+	Single = NULL;
+	int slabRows = BpttWindow > 0 ? BpttWindow + 1 : length;
+	int nWeights = GetWeightCount(specs, nLayers, nInputs);
+	if (precision == PRECISION_DOUBLE)
+	{
+		Double = new TrainingBuffers<double>(specs, nLayers, false, GetRowPtr(data->Inputs, offset),
+			data->Outputs->Data + offset, nInputs, slabRows, length);
+		if (BpttWindow > 0)
+			Double->GradientBlock = new Vector(nWeights);
+	}
+	else
+	{
+		int blockLength = precision == PRECISION_MIXED ? MixedPrecisionGradientBlock : length;
+		Single = new TrainingBuffers<float>(specs, nLayers, true, GetRowPtr(data->GetInputsF(), offset),
+			data->GetOutputsF()->Data + offset, nInputs, slabRows, blockLength);
+		Single->GradientBlock = new VectorT<float>(nWeights);
+	}
+	EvaluationAllocationCount = 0;
+	LastStatus.Code = EVAL_OK;
+	LastStatus.Layer = -1;
+	LastStatus.Timestep = -1;
+	NumWeights = nWeights;
+	ForwardPassPending = false;
+#if QUQEMATH_STATS
+	Stats.Allocations = ThreadAllocationCount - allocationsBefore;
+	Stats.BytesAllocated = ThreadAllocatedBytes - bytesBefore;
+#endif
+}
+
+TrainingContext::~TrainingContext()
+{
+	delete Double;
+	delete Single;
+	delete [] LayerSpecs;
+	Data->Release();
+}
+
+// A zero stride would never advance through the sequence, and one longer than the window would run chunks past
+// the end of the slabs. These come straight from callers of the exports, so they are checked in release builds too
+bool ValidBpttArguments(int bpttWindow, int bpttStride)
+{
+	return bpttWindow == 0 || (bpttWindow > 0 && bpttStride > 0 && bpttStride <= bpttWindow);
+}
+
+// a window outside the data set would be read past its end
+bool ValidDataWindow(SharedDataSet* data, int offset, int length)
+{
+	return offset >= 0 && length > 0 && offset <= data->NumSamples - length;
+}
+
+QUQEMATH_API void* CreateTrainingContext(
+	LayerSpec* layerSpecs, int nLayers,
+	double* trainingData, double* outputData,
+	int nInputs, int nSamples, int precision, int bpttWindow, int bpttStride)
+{
+	if (nSamples <= 0 || !ValidBpttArguments(bpttWindow, bpttStride))
+		return NULL;
+	SharedDataSet* data = new SharedDataSet(trainingData, outputData, nInputs, nSamples);
+	TrainingContext* c = new TrainingContext(layerSpecs, nLayers, data, 0, nSamples, precision, bpttWindow, bpttStride);
+	data->Release();
+	return c;
+}
+
+QUQEMATH_API void* CreateTrainingContextOnDataSet(LayerSpec* layerSpecs, int nLayers, SharedDataSet* data,
+	int offset, int length, int precision, int bpttWindow, int bpttStride)
+{
+	if (!ValidDataWindow(data, offset, length) || !ValidBpttArguments(bpttWindow, bpttStride))
+		return NULL;
+	return new TrainingContext(layerSpecs, nLayers, data, offset, length, precision, bpttWindow, bpttStride);
+}
+
+QUQEMATH_API void DestroyTrainingContext(void* context)
+{
+	delete ((TrainingContext*)context);
+}
+
+QUQEMATH_API int GetEvaluationAllocationCount(TrainingContext* c)
+{
+	return c->EvaluationAllocationCount;
+}
+
+QUQEMATH_API int GetContextStats(TrainingContext* c, ContextStats* stats)
+{
+	*stats = c->Stats;
+	return QUQEMATH_STATS;
+}
+
+QUQEMATH_API void ResetContextStats(TrainingContext* c)
+{
+	memset(&c->Stats, 0, sizeof(c->Stats));
 }
\ No newline at end of file
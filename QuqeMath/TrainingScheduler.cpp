@@ -0,0 +1,286 @@
+#include "stdafx.h"
+#include <chrono>
+#include "QuqeMath.h"
+#include "LinReg.h"
+
+TrainingJob::TrainingJob(LayerSpec* specs, int nLayers, SharedDataSet* data, int offset, int length,
+	int precision, int bpttWindow, int bpttStride, double* initialWeights, int nWeights, int epochMax, double tau)
+	: Finished(false)
+{
+	assert(ValidDataWindow(data, offset, length));
+	assert(nWeights == GetWeightCount(specs, nLayers, data->NumInputs));
+	Id = -1;
+	LayerSpecs = new LayerSpec[nLayers];
+	memcpy(LayerSpecs, specs, nLayers * sizeof(LayerSpec));
+	NumLayers = nLayers;
+	Data = data;
+	Data->AddRef();
+	Offset = offset;
+	Length = length;
+	Precision = precision;
+	BpttWindow = bpttWindow;
+	BpttStride = bpttStride;
+	InitialWeights = new Vector(nWeights, initialWeights);
+	EpochMax = epochMax;
+	Tau = tau;
+	Canceled = 0;
+	FinalWeights = new Vector(nWeights, initialWeights);
+	CostHistory = new Vector(epochMax + 1);
+	NumCosts = 0;
+	Status.Code = EVAL_OK;
+	Status.Layer = -1;
+	Status.Timestep = -1;
+	Seconds = 0;
+}
+
+TrainingJob::~TrainingJob()
+{
+	delete [] LayerSpecs;
+	delete InitialWeights;
+	delete FinalWeights;
+	delete CostHistory;
+	Data->Release();
+}
+
+bool TrainingJob::CanShareContext(TrainingJob* other)
+{
+	if (NumLayers != other->NumLayers || Data != other->Data || Offset != other->Offset || Length != other->Length
+		|| Precision != other->Precision || BpttWindow != other->BpttWindow || BpttStride != other->BpttStride)
+		return false;
+	for (int l = 0; l < NumLayers; l++)
+	{
+		LayerSpec* a = &LayerSpecs[l];
+		LayerSpec* b = &other->LayerSpecs[l];
+		if (a->NodeCount != b->NodeCount || a->IsRecurrent != b->IsRecurrent || a->ActivationType != b->ActivationType)
+			return false;
+	}
+	return true;
+}
+
+TrainingScheduler::TrainingScheduler(int nThreads, TrainingJobCallback callback, void* callbackState)
+{
+	if (nThreads <= 0)
+		nThreads = std::thread::hardware_concurrency();
+	if (nThreads <= 0)
+		nThreads = 1;
+	NumThreads = nThreads;
+	Callback = callback;
+	CallbackState = callbackState;
+	NextQueue = 0;
+	NumQueued = 0;
+	NumUnfinished = 0;
+	Stopping = false;
+	for (int i = 0; i < nThreads; i++)
+	{
+		Queues.push_back(new WorkQueue());
+		Queues[i]->Count = 0;
+	}
+	for (int i = 0; i < nThreads; i++)
+		Threads.push_back(std::thread(&TrainingScheduler::WorkerLoop, this, i));
+}
+
+TrainingScheduler::~TrainingScheduler()
+{
+	Cancel(-1);
+	Wait();
+	{
+		std::lock_guard<std::mutex> lock(StateLock);
+		Stopping = true;
+	}
+	WorkAvailable.notify_all();
+	for (size_t i = 0; i < Threads.size(); i++)
+		Threads[i].join();
+	for (size_t i = 0; i < Queues.size(); i++)
+		delete Queues[i];
+	for (size_t i = 0; i < Jobs.size(); i++)
+		delete Jobs[i];
+}
+
+// jobs are dealt out round robin; stealing evens out whatever imbalance that leaves
+int TrainingScheduler::Submit(TrainingJob* job)
+{
+	int queue;
+	{
+		std::lock_guard<std::mutex> lock(JobsLock);
+		job->Id = (int)Jobs.size();
+		Jobs.push_back(job);
+		queue = NextQueue;
+		NextQueue = (NextQueue + 1) % NumThreads;
+	}
+	{
+		// a worker checks NumQueued under StateLock before it waits, so it either sees this job or gets the notify
+		std::lock_guard<std::mutex> state(StateLock);
+		NumUnfinished++;
+		WorkQueue* q = Queues[queue];
+		std::lock_guard<std::mutex> lock(q->Lock);
+		q->Jobs.push_back(job);
+		q->Count = (int)q->Jobs.size();
+		NumQueued++;
+	}
+	WorkAvailable.notify_one();
+	return job->Id;
+}
+
+TrainingJob* TrainingScheduler::GetJob(int id)
+{
+	std::lock_guard<std::mutex> lock(JobsLock);
+	return id >= 0 && id < (int)Jobs.size() ? Jobs[id] : NULL;
+}
+
+void TrainingScheduler::Cancel(int id)
+{
+	std::lock_guard<std::mutex> lock(JobsLock);
+	for (size_t i = 0; i < Jobs.size(); i++)
+		if (id < 0 || (int)i == id)
+			Jobs[i]->Canceled = 1;
+}
+
+void TrainingScheduler::Wait()
+{
+	std::unique_lock<std::mutex> lock(StateLock);
+	AllFinished.wait(lock, [this] { return NumUnfinished == 0; });
+}
+
+// The front of the thread's own queue, or failing that of the fullest other queue. Jobs are independent, so
+// thieves gain nothing from taking the newest; taking the oldest keeps the longest-first order of submission
+TrainingJob* TrainingScheduler::Take(int thread)
+{
+	TrainingJob* job = NULL;
+	{
+		WorkQueue* own = Queues[thread];
+		std::lock_guard<std::mutex> lock(own->Lock);
+		if (!own->Jobs.empty())
+		{
+			job = own->Jobs.front();
+			own->Jobs.pop_front();
+			own->Count = (int)own->Jobs.size();
+			NumQueued--;
+		}
+	}
+	while (job == NULL)
+	{
+		// counts are read without the locks, so the choice can be stale; recheck under the victim's lock
+		int victim = -1;
+		int most = 0;
+		for (int i = 0; i < NumThreads; i++)
+		{
+			int size = Queues[i]->Count;
+			if (i != thread && size > most)
+			{
+				victim = i;
+				most = size;
+			}
+		}
+		if (victim < 0)
+			return NULL;
+		WorkQueue* q = Queues[victim];
+		std::lock_guard<std::mutex> lock(q->Lock);
+		if (!q->Jobs.empty())
+		{
+			job = q->Jobs.front();
+			q->Jobs.pop_front();
+			q->Count = (int)q->Jobs.size();
+			NumQueued--;
+		}
+	}
+	return job;
+}
+
+// context is the thread's last training context and contextJob the job it was made for
+void TrainingScheduler::Run(TrainingJob* job, TrainingContext*& context, TrainingJob*& contextJob)
+{
+	if (!job->Canceled)
+	{
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		if (context == NULL || !job->CanShareContext(contextJob))
+		{
+			delete context;
+			context = new TrainingContext(job->LayerSpecs, job->NumLayers, job->Data, job->Offset, job->Length,
+				job->Precision, job->BpttWindow, job->BpttStride);
+		}
+		contextJob = job;
+		job->NumCosts = TrainSCG(context, job->InitialWeights->Data, job->InitialWeights->Count, job->EpochMax, job->Tau,
+			&job->Canceled, job->FinalWeights->Data, job->CostHistory->Data);
+		job->Status = context->LastStatus;
+		job->Seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+	job->Finished = true;
+
+	if (Callback != NULL)
+		Callback(job->Id, CallbackState);
+	bool allFinished;
+	{
+		std::lock_guard<std::mutex> lock(StateLock);
+		allFinished = --NumUnfinished == 0;
+	}
+	if (allFinished)
+		AllFinished.notify_all();
+}
+
+void TrainingScheduler::WorkerLoop(int thread)
+{
+	TrainingContext* context = NULL;
+	TrainingJob* contextJob = NULL;
+	while (true)
+	{
+		TrainingJob* job = Take(thread);
+		if (job != NULL)
+		{
+			Run(job, context, contextJob);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(StateLock);
+		WorkAvailable.wait(lock, [this] { return Stopping || NumQueued > 0; });
+		if (Stopping)
+			break;
+	}
+	delete context;
+}
+
+QUQEMATH_API void* CreateTrainingScheduler(int nThreads, TrainingJobCallback callback, void* callbackState)
+{
+	return new TrainingScheduler(nThreads, callback, callbackState);
+}
+
+QUQEMATH_API int SubmitTrainingJob(TrainingScheduler* s, LayerSpec* layerSpecs, int nLayers, SharedDataSet* data,
+	int offset, int length, int precision, int bpttWindow, int bpttStride, double* initialWeights, int nWeights,
+	int epochMax, double tau)
+{
+	if (!ValidDataWindow(data, offset, length) || !ValidBpttArguments(bpttWindow, bpttStride)
+		|| nWeights != GetWeightCount(layerSpecs, nLayers, data->NumInputs))
+		return -1;
+	TrainingJob* job = new TrainingJob(layerSpecs, nLayers, data, offset, length, precision,
+		bpttWindow, bpttStride, initialWeights, nWeights, epochMax, tau);
+	return s->Submit(job);
+}
+
+QUQEMATH_API void CancelTrainingJob(TrainingScheduler* s, int job)
+{
+	s->Cancel(job);
+}
+
+QUQEMATH_API void WaitForTrainingJobs(TrainingScheduler* s)
+{
+	s->Wait();
+}
+
+QUQEMATH_API int GetTrainingJobResult(TrainingScheduler* s, int job, double* finalWeights, double* costHistory,
+	EvaluationStatus* status, double* seconds)
+{
+	TrainingJob* j = s->GetJob(job);
+	if (j == NULL)
+		return -2;
+	if (!j->Finished)
+		return -1;
+	memcpy(finalWeights, j->FinalWeights->Data, j->FinalWeights->Count * sizeof(double));
+	memcpy(costHistory, j->CostHistory->Data, j->NumCosts * sizeof(double));
+	*status = j->Status;
+	*seconds = j->Seconds;
+	return j->NumCosts;
+}
+
+QUQEMATH_API void DestroyTrainingScheduler(void* s)
+{
+	delete ((TrainingScheduler*)s);
+}
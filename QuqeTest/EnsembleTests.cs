@@ -0,0 +1,56 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using Machine.Specifications;
+using NUnit.Framework;
+using Quqe;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  class EnsembleTests
+  {
+    [Test]
+    public void EnsembleMatchesIndividualExperts()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var numInputs = data.Input.RowCount;
+      var numSteps = data.Input.ColumnCount;
+
+      // the RBF net sees the first rbfInputs rows, the RNN everything from row rnnOffset on
+      const int rbfInputs = 4;
+      const int rnnOffset = 2;
+      var rbfData = data.Input.SubMatrix(0, rbfInputs, 0, numSteps);
+      var rnnData = data.Input.SubMatrix(rnnOffset, numInputs - rnnOffset, 0, numSteps);
+      var rbfNet = RBFNet.Train(rbfData, data.Output, 0.1, 1);
+      var layers = new List<LayerSpec> {
+        new LayerSpec(6, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(1, false, ActivationType.Linear)
+      };
+      var rnnSpec = new RNNSpec(rnnData.RowCount, layers, QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, rnnData.RowCount), -1, 1));
+
+      double[] rnnOutputs;
+      using (var rnn = new RNN(rnnSpec))
+        rnnOutputs = rnn.PredictSequence(rnnData).ToArray();
+      var rbfOutputs = Enumerable.Range(0, numSteps).Select(t => rbfNet.Predict(rbfData.Column(t))).ToArray();
+
+      var rowWiseInputs = data.Input.ToRowWiseArray();
+      foreach (var numThreads in new[] { 1, 4 })
+      {
+        using (var ensemble = RNNInterop.CreateEnsembleContext(numInputs, 2))
+        {
+          RNNInterop.AddRnnMember(ensemble, rnnOffset, rnnSpec);
+          RNNInterop.AddRbfMember(ensemble, 0, rbfNet);
+          var prediction = RNNInterop.PredictEnsemble(ensemble, rowWiseInputs, numSteps, 0, numSteps, numThreads);
+
+          prediction.MemberOutputs.Row(0).ToArray().ShouldEqual(rnnOutputs);
+          for (int t = 0; t < numSteps; t++)
+          {
+            prediction.MemberOutputs[1, t].ShouldBeCloseTo(rbfOutputs[t], 1e-9);
+            prediction.Votes[t].ShouldEqual((double)Math.Sign((rnnOutputs[t] + prediction.MemberOutputs[1, t]) / 2));
+          }
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,81 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Linq;
+using NUnit.Framework;
+using Quqe;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  public class QuqeMathActivation
+  {
+    [Test]
+    public void LogisticSigmoidKernelsMatchLibm()
+    {
+      // the vectorized kernels clamp exp's argument, so below -708 they only promise a tiny absolute error
+      const double maxRelativeError = 4.5e-16; // 2 ulps
+      const double maxAbsoluteError = 1e-307;
+      var xs = Lists.Repeat(100001, i => -800 + i * 0.016)
+        .Concat(Lists.Repeat(100001, i => -40 + i * 0.0008))
+        .Concat(new[] { 0, -0.0, double.Epsilon, double.PositiveInfinity, double.NegativeInfinity })
+        .ToArray();
+
+      foreach (var kernel in SupportedKernels())
+      {
+        // odd lengths exercise the tail handling
+        foreach (var n in new[] { xs.Length, xs.Length - 1, 1, 3, 5, 7, 9 })
+        {
+          var x = xs.Take(n).ToArray();
+          var y = RNNInterop.ApplyLogisticSigmoid(x, kernel);
+          for (int i = 0; i < n; i++)
+          {
+            var expected = 1 / (1 + Math.Exp(-x[i]));
+            var err = Math.Abs(y[i] - expected);
+            if (x[i] >= -708)
+              Assert.LessOrEqual(err, maxRelativeError * expected, kernel + " at x = " + x[i]);
+            else
+              Assert.LessOrEqual(err, maxAbsoluteError, kernel + " at x = " + x[i]);
+          }
+        }
+      }
+    }
+
+    [Test]
+    public void LogisticSigmoidKernelsPropagateNaN()
+    {
+      foreach (var kernel in SupportedKernels())
+      {
+        var y = RNNInterop.ApplyLogisticSigmoid(new[] { double.NaN, 1, double.NaN, 0, double.NaN }, kernel);
+        Assert.IsTrue(double.IsNaN(y[0]) && double.IsNaN(y[2]) && double.IsNaN(y[4]), kernel.ToString());
+        Assert.AreEqual(0.5, y[3]);
+      }
+    }
+
+    [Test]
+    public void ExpKernelsMatchLibm()
+    {
+      const double maxRelativeError = 4.5e-16; // 2 ulps
+      var xs = Lists.Repeat(200001, i => -708 + i * 0.00708).Concat(Lists.Repeat(100001, i => i * 0.00709)).ToArray();
+
+      foreach (var kernel in SupportedKernels())
+      {
+        foreach (var n in new[] { xs.Length, 1, 3, 5, 7, 9 })
+        {
+          var x = xs.Take(n).ToArray();
+          var y = RNNInterop.ApplyExp(x, kernel);
+          for (int i = 0; i < n; i++)
+          {
+            var expected = Math.Exp(x[i]);
+            Assert.LessOrEqual(Math.Abs(y[i] - expected), maxRelativeError * expected, kernel + " at x = " + x[i]);
+          }
+        }
+      }
+    }
+
+    static IEnumerable<ActivationKernel> SupportedKernels()
+    {
+      var best = RNNInterop.GetActivationKernel();
+      return Enum.GetValues(typeof(ActivationKernel)).Cast<ActivationKernel>().Where(k => k <= best);
+    }
+  }
+}
@@ -0,0 +1,74 @@
+﻿using System.Collections.Generic;
+using System.Linq;
+using System.Threading;
+using MathNet.Numerics.Distributions;
+using MathNet.Numerics.LinearAlgebra.Double;
+using MathNet.Numerics.LinearAlgebra.Generic;
+using NUnit.Framework;
+using Quqe;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  public class QuqeMathConcurrency
+  {
+    [Test]
+    public void TrainingContextsAreReentrant()
+    {
+      const int numThreads = 16;
+      const int numIterations = 200;
+      const int numInputs = 30;
+      const int numSamples = 50;
+      var layerSpecs = new List<LayerSpec> {
+        new LayerSpec(12, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(6, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(1, false, ActivationType.Linear)
+      };
+      var weightCount = RNNInterop.GetWeightCount(layerSpecs, numInputs);
+      var trainingData = Lists.Repeat(numSamples, _ => MakeVector(numInputs)).ColumnsToMatrix();
+      var outputData = MakeVector(numSamples);
+      var weights = MakeVector(weightCount);
+
+      RNNInterop.WeightEvalInfo expected;
+      using (var context = RNNInterop.CreateTrainingContext(layerSpecs, trainingData, outputData))
+        expected = context.EvaluateWeights(weights);
+
+      int numMismatches = 0;
+      var threads = Lists.Repeat(numThreads, _ => new Thread(() => {
+        for (int i = 0; i < numIterations; i++)
+        {
+          if (RNNInterop.GetWeightCount(layerSpecs, numInputs) != weightCount)
+            Interlocked.Increment(ref numMismatches);
+          using (var context = RNNInterop.CreateTrainingContext(layerSpecs, trainingData, outputData))
+          {
+            var actual = context.EvaluateWeights(weights);
+            if (actual.Error != expected.Error || !actual.Gradient.SequenceEqual(expected.Gradient))
+              Interlocked.Increment(ref numMismatches);
+          }
+        }
+      }));
+      foreach (var t in threads)
+        t.Start();
+      foreach (var t in threads)
+        t.Join();
+
+      Assert.AreEqual(0, numMismatches);
+    }
+
+    [Test]
+    public void WeightCountIsComputedFromLayerSpecs()
+    {
+      var layerSpecs = new List<LayerSpec> {
+        new LayerSpec(8, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(4, false, ActivationType.LogisticSigmoid),
+        new LayerSpec(1, false, ActivationType.Linear)
+      };
+      Assert.AreEqual((8 * 10 + 8 * 8 + 8) + (4 * 8 + 4) + (1 * 4 + 1), RNNInterop.GetWeightCount(layerSpecs, 10));
+    }
+
+    static Vector<double> MakeVector(int size)
+    {
+      return DenseVector.CreateRandom(size, new ContinuousUniform());
+    }
+  }
+}
@@ -0,0 +1,54 @@
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using MathNet.Numerics.Distributions;
+using MathNet.Numerics.LinearAlgebra.Double;
+using MathNet.Numerics.LinearAlgebra.Generic;
+using NUnit.Framework;
+using Quqe;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  public class QuqeMathPerformance
+  {
+    [Test, Explicit("benchmark")]
+    public void EvaluateWeightsTiming()
+    {
+      const int numInputs = 30;
+      foreach (var nodeCount in new[] { 2, 8, 32, 64 })
+      {
+        foreach (var numSamples in new[] { 500, 3000 })
+        {
+          var layerSpecs = new List<LayerSpec> {
+            new LayerSpec(nodeCount, true, ActivationType.LogisticSigmoid),
+            new LayerSpec(Math.Max(1, nodeCount / 2), true, ActivationType.LogisticSigmoid),
+            new LayerSpec(1, false, ActivationType.Linear)
+          };
+          var trainingData = Lists.Repeat(numSamples, _ => MakeVector(numInputs)).ColumnsToMatrix();
+          var outputData = MakeVector(numSamples);
+          var weights = MakeVector(RNNInterop.GetWeightCount(layerSpecs, numInputs)) * 0.1;
+
+          using (var context = RNNInterop.CreateTrainingContext(layerSpecs, trainingData, outputData))
+          {
+            context.EvaluateWeights(weights);
+            var sw = Stopwatch.StartNew();
+            int numEvaluations = 0;
+            while (sw.ElapsedMilliseconds < 1000)
+            {
+              context.EvaluateWeights(weights);
+              numEvaluations++;
+            }
+            Trace.WriteLine(string.Format("{0} nodes, {1} samples: {2:F3} ms/evaluation",
+              nodeCount, numSamples, sw.Elapsed.TotalMilliseconds / numEvaluations));
+          }
+        }
+      }
+    }
+
+    static Vector<double> MakeVector(int size)
+    {
+      return DenseVector.CreateRandom(size, new ContinuousUniform(-1, 1));
+    }
+  }
+}
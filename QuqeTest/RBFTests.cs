@@ -1,43 +1,101 @@
-﻿using System;
-using System.Diagnostics;
-using System.Linq;
-using Machine.Specifications;
-using NUnit.Framework;
-using Quqe;
-using Quqe.NewVersace;
-
-namespace QuqeTest
-{
-  [TestFixture]
-  class RBFTests
-  {
-    [Test]
-    public void RBFTrainingIsReproducible()
-    {
-      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
-      var fitnesses = Lists.Repeat(5, i => {
-        var rbfNet = RBFNet.Train(data.Input, data.Output, 0.1, 1);
-        rbfNet.IsDegenerate.ShouldBeFalse();
-        return Functions.ComputeFitness(new PredictorWithInputs(rbfNet, data.Input), data);
-      });
-      fitnesses.Distinct().Count().ShouldEqual(1);
-    }
-
-    [Test]
-    public void RBFPredictsWell()
-    {
-      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
-
-      Func<double, double> fitnessForTolerance = tolerance => {
-        var rbfNet = RBFNet.Train(data.Input, data.Output, tolerance, 1);
-        rbfNet.IsDegenerate.ShouldBeFalse();
-        var fitness = Functions.ComputeFitness(new PredictorWithInputs(rbfNet, data.Input), data);
-        Trace.WriteLine("RBF fitness: " + fitness);
-        return fitness;
-      };
-
-      fitnessForTolerance(0.2).ShouldBeGreaterThan(0.9);
-      fitnessForTolerance(0.01).ShouldEqual(1.0);
-    }
-  }
-}
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using Machine.Specifications;
+using NUnit.Framework;
+using Quqe;
+using Quqe.NewVersace;
+using MathNet.Numerics.LinearAlgebra.Double;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  class RBFTests
+  {
+    [Test]
+    public void RBFTrainingIsReproducible()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var fitnesses = Lists.Repeat(5, i => {
+        var rbfNet = RBFNet.Train(data.Input, data.Output, 0.1, 1);
+        rbfNet.IsDegenerate.ShouldBeFalse();
+        return Functions.ComputeFitness(new PredictorWithInputs(rbfNet, data.Input), data);
+      });
+      fitnesses.Distinct().Count().ShouldEqual(1);
+    }
+
+    [Test]
+    public void RBFPredictsWell()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+
+      Func<double, double> fitnessForTolerance = tolerance => {
+        var rbfNet = RBFNet.Train(data.Input, data.Output, tolerance, 1);
+        rbfNet.IsDegenerate.ShouldBeFalse();
+        var fitness = Functions.ComputeFitness(new PredictorWithInputs(rbfNet, data.Input), data);
+        Trace.WriteLine("RBF fitness: " + fitness);
+        return fitness;
+      };
+
+      fitnessForTolerance(0.2).ShouldBeGreaterThan(0.9);
+      fitnessForTolerance(0.01).ShouldEqual(1.0);
+    }
+
+    [Test]
+    public void NativePredictionMatchesGaussianSum()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var rbfNet = RBFNet.Train(data.Input, data.Output, 0.05, 1);
+      var sequence = rbfNet.PredictSequence(data.Input);
+      for (int t = 0; t < data.Input.ColumnCount; t++)
+      {
+        var x = data.Input.Column(t);
+        var expected = rbfNet.OutputBias + rbfNet.Bases.Sum(b => b.Weight * RBFNet.Gaussian(rbfNet.Spread, (x - b.Center).Norm(2)));
+        rbfNet.Predict(x).ShouldBeCloseTo(expected, 1e-9);
+        sequence[t].ShouldBeCloseTo(expected, 1e-9);
+      }
+    }
+
+    [Test]
+    public void OLSSelectionMatchesGramSchmidtReference()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      const double tolerance = 0.1;
+      const double spread = 1;
+      var xs = data.Input.Columns();
+      var n = xs.Count;
+
+      // the straightforward selection: orthogonalize every remaining candidate against everything selected so far
+      var candidates = xs.Select(c => (Vec)new DenseVector(xs.Select(x => RBFNet.Gaussian(spread, (x - c).Norm(2))).ToArray())).ToList();
+      var d = data.Output.Subtract(data.Output.Average()).Normalize(2);
+      var remaining = Enumerable.Range(0, n).ToList();
+      var selected = new List<int>();
+      var orthoBases = new List<Vec>();
+      double qualityTotal = 0;
+      while (remaining.Any())
+      {
+        var best = remaining.Select(j => {
+          var w = RBFNet.Orthogonalize(candidates[j], orthoBases).Normalize(2);
+          return new { Index = j, OrthoBasis = w, Quality = Math.Pow(w.DotProduct(d), 2) };
+        }).OrderByDescending(x => x.Quality).First();
+        remaining.Remove(best.Index);
+        selected.Add(best.Index);
+        orthoBases.Add(best.OrthoBasis);
+        qualityTotal += best.Quality;
+        if (1 - qualityTotal < tolerance)
+          break;
+      }
+      var expectedWeights = RBFNet.SolveLS(
+        new Vec[] { DenseVector.Create(n, _ => 1) }.Concat(selected.Select(j => candidates[j])).ColumnsToMatrix(), data.Output);
+
+      var solution = RBFNet.SolveOLS(xs, data.Output.ToList(), tolerance, spread);
+      solution.IsDegenerate.ShouldBeFalse();
+      solution.Bases.Count.ShouldEqual(selected.Count + 1);
+      solution.Bases.Skip(1).Select(b => xs.IndexOf(b.Center)).ToList().ShouldEqual(selected);
+      for (int i = 0; i < expectedWeights.Count; i++)
+        solution.Bases[i].Weight.ShouldBeCloseTo(expectedWeights[i], 1e-6 * (1 + Math.Abs(expectedWeights[i])));
+    }
+  }
+}
@@ -1,66 +1,419 @@
-﻿using System;
-using System.Collections.Generic;
-using System.Diagnostics;
-using System.Linq;
-using Machine.Specifications;
-using NUnit.Framework;
-using Quqe;
-using Quqe.NewVersace;
-using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
-
-namespace QuqeTest
-{
-  [TestFixture]
-  public class RNNTests
-  {
-    [Test]
-    public void RNNTrainingIsReproducible()
-    {
-      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
-
-      var checksums = Lists.Repeat(5, i => {
-        QuqeUtil.Random = new Random(42);
-        var trainResult = Train(data, 8, 4, 1000);
-        return NNTestUtils.Checksum(trainResult.RNNSpec.Weights);
-      });
-      checksums.Distinct().Count().ShouldEqual(1);
-    }
-
-    [Test]
-    public void RNNPredictsWell()
-    {
-      QuqeUtil.Random = new Random(42);
-      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
-      var trainResult = Train(data, 8, 4, 1000);
-      var trainingFitness = Functions.ComputeFitness(new PredictorWithInputs(new RNN(trainResult.RNNSpec), data.Input), data);
-      
-      Trace.WriteLine("Training fitness: " + trainingFitness);
-      trainingFitness.ShouldEqual(0.968);
-    }
-
-    [Test]
-    public void RNNTrainsQuickly()
-    {
-      var sw = new Stopwatch();
-      sw.Start();
-      var trainingData = NNTestUtils.GetData("2004-01-01", "2005-01-01");
-      Train(trainingData, 32, 16, 1000);
-      sw.Stop();
-      sw.ElapsedMilliseconds.ShouldBeGreaterThan(2000).ShouldBeLessThan(17000);
-    }
-
-    static RnnTrainResult Train(DataSet data, int layer1NodeCount, int layer2NodeCount, int epochMax)
-    {
-      var numInputs = data.Input.RowCount;
-      var layers = new List<LayerSpec> {
-        new LayerSpec(layer1NodeCount, true, ActivationType.LogisticSigmoid),
-        new LayerSpec(layer2NodeCount, true, ActivationType.LogisticSigmoid),
-        new LayerSpec(1, false, ActivationType.Linear)
-      };
-
-      var weightCount = RNN.GetWeightCount(layers, numInputs);
-      var initialWeights = QuqeUtil.MakeRandomVector(weightCount, -1, 1);
-      return RNN.TrainSCG(layers, initialWeights, epochMax, data.Input, data.Output);
-    }
-  }
-}
+﻿using System;
+using System.Collections.Generic;
+using System.Diagnostics;
+using System.Linq;
+using System.Threading;
+using Machine.Specifications;
+using NUnit.Framework;
+using Quqe;
+using Quqe.NewVersace;
+using Vec = MathNet.Numerics.LinearAlgebra.Generic.Vector<double>;
+
+namespace QuqeTest
+{
+  [TestFixture]
+  public class RNNTests
+  {
+    [Test]
+    public void RNNTrainingIsReproducible()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+
+      var checksums = Lists.Repeat(5, i => {
+        QuqeUtil.Random = new Random(42);
+        var trainResult = Train(data, 8, 4, 1000);
+        return NNTestUtils.Checksum(trainResult.RNNSpec.Weights);
+      });
+      checksums.Distinct().Count().ShouldEqual(1);
+    }
+
+    [Test]
+    public void RNNPredictsWell()
+    {
+      QuqeUtil.Random = new Random(42);
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var trainResult = Train(data, 8, 4, 1000);
+      var trainingFitness = Functions.ComputeFitness(new PredictorWithInputs(new RNN(trainResult.RNNSpec), data.Input), data);
+      
+      Trace.WriteLine("Training fitness: " + trainingFitness);
+      trainingFitness.ShouldEqual(0.968);
+    }
+
+    [Test]
+    public void RNNTrainsQuickly()
+    {
+      var sw = new Stopwatch();
+      sw.Start();
+      var trainingData = NNTestUtils.GetData("2004-01-01", "2005-01-01");
+      Train(trainingData, 32, 16, 1000);
+      sw.Stop();
+      sw.ElapsedMilliseconds.ShouldBeGreaterThan(2000).ShouldBeLessThan(17000);
+    }
+
+    [Test]
+    public void RNNTrainingCanBeCancelled()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var trainResult = Train(data, 8, 4, 1000000, () => true);
+      trainResult.CostHistory.Count.ShouldBeLessThan(1000);
+    }
+
+    [Test]
+    public void ReducedPrecisionTrainingReachesDoubleCost()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var layers = MakeLayers(8, 4);
+      var initialWeights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      Func<TrainingPrecision, double> finalCost = precision =>
+        RNN.TrainSCG(layers, initialWeights, 500, data.Input, data.Output, null, precision).Cost;
+
+      var doubleCost = finalCost(TrainingPrecision.Double);
+      foreach (var precision in new[] { TrainingPrecision.Single, TrainingPrecision.Mixed })
+      {
+        var cost = finalCost(precision);
+        Trace.WriteLine(string.Format("{0} precision final cost {1}, double {2}", precision, cost, doubleCost));
+        cost.ShouldBeLessThan(doubleCost * 1.1);
+      }
+    }
+
+    [Test]
+    public void TruncatedBpttWithFullWindowMatchesFullGradient()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-05-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      var numSamples = data.Input.ColumnCount;
+
+      RNNInterop.WeightEvalInfo full, truncated;
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+        full = context.EvaluateWeights(weights);
+      // a window reaching back to the start gives every error its whole history, just in chunks
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output, TrainingPrecision.Double,
+                                                            new TruncatedBptt(numSamples, 7)))
+        truncated = context.EvaluateWeights(weights);
+
+      truncated.Error.ShouldBeCloseTo(full.Error, 1e-9);
+      truncated.Output[0].ShouldBeCloseTo(full.Output[0], 1e-12);
+      (truncated.Gradient - full.Gradient).Norm(2).ShouldBeLessThan(1e-9);
+    }
+
+    [Test]
+    public void TruncatedBpttTrainingReducesCost()
+    {
+      QuqeUtil.Random = new Random(42);
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var layers = MakeLayers(8, 4);
+      var initialWeights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      var result = RNN.TrainSCG(layers, initialWeights, 300, data.Input, data.Output, null, TrainingPrecision.Double,
+                                new TruncatedBptt(20, 10));
+      result.Cost.ShouldBeLessThan(result.CostHistory.First() / 2);
+    }
+
+    [Test]
+    public void DataSetWindowMatchesCopiedWindow()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      const int offset = 23;
+      const int length = 50;
+      var input = data.Input.SubMatrix(0, data.Input.RowCount, offset, length);
+      var output = data.Output.SubVector(offset, length);
+
+      foreach (var precision in new[] { TrainingPrecision.Double, TrainingPrecision.Mixed })
+      {
+        RNNInterop.WeightEvalInfo copied, shared;
+        using (var context = RNNInterop.CreateTrainingContext(layers, input, output, precision))
+          copied = context.EvaluateWeights(weights);
+        // the context holds its own reference, so it outlives the handle
+        RNNInterop.TrainingContext windowContext;
+        using (var dataSet = RNNInterop.CreateDataSet(data.Input, data.Output))
+          windowContext = RNNInterop.CreateTrainingContext(layers, dataSet, offset, length, precision);
+        using (windowContext)
+          shared = windowContext.EvaluateWeights(weights);
+
+        shared.Error.ShouldEqual(copied.Error);
+        shared.Gradient.ShouldEqual(copied.Gradient);
+      }
+    }
+
+    [Test]
+    public void ScheduledTrainingMatchesSerialTraining()
+    {
+      QuqeUtil.Random = new Random(42);
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var layers = MakeLayers(8, 4);
+      var numWeights = RNN.GetWeightCount(layers, data.Input.RowCount);
+      var windows = new[] { Tuple2.Create(0, 100), Tuple2.Create(20, 60), Tuple2.Create(0, 100), Tuple2.Create(40, 30) };
+      var initialWeights = windows.Select(_ => QuqeUtil.MakeRandomVector(numWeights, -1, 1)).ToList();
+
+      using (var dataSet = RNNInterop.CreateDataSet(data.Input, data.Output))
+      {
+        int numCompleted = 0;
+        using (var scheduler = RNNInterop.CreateTrainingScheduler(2, job => Interlocked.Increment(ref numCompleted)))
+        {
+          var jobs = windows.Select((w, i) => scheduler.SubmitTrainingJob(layers, dataSet, w.Item1, w.Item2, initialWeights[i], 50, RNN.SCGTau)).ToList();
+          jobs.SequenceEqual(new[] { 0, 1, 2, 3 }).ShouldBeTrue();
+          scheduler.WaitForTrainingJobs();
+          numCompleted.ShouldEqual(windows.Length);
+
+          for (int i = 0; i < windows.Length; i++)
+          {
+            var serial = RNN.TrainSCG(layers, initialWeights[i], 50, dataSet, windows[i].Item1, windows[i].Item2);
+            var scheduled = scheduler.GetTrainingJobResult(jobs[i]);
+            scheduled.CostHistory.SequenceEqual(serial.CostHistory).ShouldBeTrue();
+            scheduled.Weights.ShouldEqual(serial.RNNSpec.Weights);
+          }
+        }
+      }
+    }
+
+    [Test]
+    public void CanceledTrainingJobsFinishPromptly()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+
+      using (var dataSet = RNNInterop.CreateDataSet(data.Input, data.Output))
+      using (var scheduler = RNNInterop.CreateTrainingScheduler(2))
+      {
+        var jobs = Lists.Repeat(8, _ => scheduler.SubmitTrainingJob(layers, dataSet, 0, dataSet.NumSamples, weights, 1000000, 0));
+        var sw = Stopwatch.StartNew();
+        scheduler.CancelAllTrainingJobs();
+        scheduler.WaitForTrainingJobs();
+        sw.ElapsedMilliseconds.ShouldBeLessThan(5000L);
+        foreach (var job in jobs)
+          scheduler.GetTrainingJobResult(job).CostHistory.Count.ShouldBeLessThan(1000000);
+      }
+    }
+
+    [Test]
+    public void ContextStatsCountEachPhase()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+      {
+        var stats = context.GetStats();
+        if (stats == null)
+          Assert.Ignore("QuqeMath was built without stats");
+        stats[TrainingPhase.Setup].Calls.ShouldEqual(1);
+        stats.Allocations.ShouldBeGreaterThan(0L);
+
+        context.ResetStats();
+        for (int i = 0; i < 3; i++)
+          context.EvaluateWeights(weights * (1 + i * 0.01));
+        stats = context.GetStats();
+        stats.Evaluations.ShouldEqual(3);
+        stats.Allocations.ShouldEqual(0);
+        stats[TrainingPhase.Setup].Calls.ShouldEqual(0);
+        foreach (var phase in new[] { TrainingPhase.Forward, TrainingPhase.Backward, TrainingPhase.Gradient })
+          stats[phase].Calls.ShouldEqual(3);
+        stats[TrainingPhase.SetWeights].Calls.ShouldEqual(0); // the double layers view the weights in place
+        stats[TrainingPhase.Forward].Flops.ShouldBeGreaterThan(0.0);
+        stats[TrainingPhase.Gradient].Nanoseconds.ShouldBeGreaterThan(0L);
+      }
+    }
+
+    [Test]
+    public void EvaluateErrorIsResumedByEvaluateGradient()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+
+      RNNInterop.WeightEvalInfo expected;
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+        expected = context.EvaluateWeights(weights);
+
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+      {
+        var stats = context.GetStats();
+        if (stats == null)
+          Assert.Ignore("QuqeMath was built without stats");
+
+        context.ResetStats();
+        var errorOnly = context.EvaluateError(weights);
+        errorOnly.Error.ShouldEqual(expected.Error);
+        errorOnly.Output.ShouldEqual(expected.Output);
+        (errorOnly.Gradient == null).ShouldBeTrue();
+        var full = context.EvaluateGradient(weights, errorOnly);
+        full.Error.ShouldEqual(expected.Error);
+        full.Output.ShouldEqual(expected.Output);
+        full.Gradient.ShouldEqual(expected.Gradient);
+
+        stats = context.GetStats();
+        stats.Evaluations.ShouldEqual(1);
+        stats.ResumedEvaluations.ShouldEqual(1);
+        stats[TrainingPhase.Forward].Calls.ShouldEqual(1);
+        stats[TrainingPhase.Backward].Calls.ShouldEqual(1);
+
+        // with nothing to resume, the whole evaluation is rerun
+        context.EvaluateGradient(weights, errorOnly).Gradient.ShouldEqual(expected.Gradient);
+        stats = context.GetStats();
+        stats[TrainingPhase.Forward].Calls.ShouldEqual(2);
+        stats.Evaluations.ShouldEqual(2);
+        stats.ResumedEvaluations.ShouldEqual(1);
+      }
+    }
+
+    [Test]
+    public void EvaluationDoesNotKeepTheCallersWeights()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      int weightCount = RNN.GetWeightCount(layers, data.Input.RowCount);
+      var first = QuqeUtil.MakeRandomVector(weightCount, -1, 1);
+      var second = QuqeUtil.MakeRandomVector(weightCount, -1, 1);
+
+      RNNInterop.WeightEvalInfo expected;
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+        expected = context.EvaluateWeights(second);
+
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+      {
+        // the weights are read in place, so changing them afterwards must not change what was evaluated
+        var weights = first.Clone();
+        context.EvaluateError(weights);
+        for (int i = 0; i < weightCount; i++)
+          weights[i] = second[i];
+        var result = context.EvaluateWeights(weights);
+        result.Error.ShouldEqual(expected.Error);
+        result.Gradient.ShouldEqual(expected.Gradient);
+        weights.ShouldEqual(second);
+      }
+    }
+
+    [Test]
+    public void NonFiniteEvaluationReportsWhereAndStopsTraining()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      var input = data.Input.Clone();
+      input[2, 17] = double.NaN;
+
+      using (var context = RNNInterop.CreateTrainingContext(layers, input, data.Output))
+      {
+        var eval = context.EvaluateWeights(weights);
+        eval.Status.Code.ShouldEqual(EvaluationStatusCode.NonFiniteActivation);
+        eval.Status.Layer.ShouldEqual(0);
+        eval.Status.Timestep.ShouldEqual(17);
+        double.IsNaN(eval.Error).ShouldBeTrue();
+        eval.Output.All(double.IsNaN).ShouldBeTrue();
+
+        var scg = context.TrainSCG(weights, 1000, 0.00001);
+        scg.CostHistory.Count.ShouldEqual(1);
+        scg.Status.Code.ShouldEqual(EvaluationStatusCode.NonFiniteActivation);
+      }
+
+      var badWeights = weights.Clone();
+      badWeights[badWeights.Count - 1] = double.PositiveInfinity;
+      using (var context = RNNInterop.CreateTrainingContext(layers, data.Input, data.Output))
+      {
+        var eval = context.EvaluateWeights(badWeights);
+        eval.Status.Code.ShouldEqual(EvaluationStatusCode.NonFiniteWeights);
+        eval.Status.Layer.ShouldEqual(layers.Count - 1);
+        eval.Output.All(double.IsNaN).ShouldBeTrue();
+        context.EvaluateWeights(weights).Status.IsOk.ShouldBeTrue();
+      }
+    }
+
+    [Test]
+    public void BatchEvaluationMatchesSingleSequenceEvaluation()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-07-01");
+      var layers = MakeLayers(8, 4);
+      var weights = QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, data.Input.RowCount), -1, 1);
+      var offsets = new[] { 0, 5, 17, 40 };
+      const int windowLength = 60;
+
+      List<RNNInterop.WeightEvalInfo> batchResults;
+      using (var bc = RNNInterop.CreateBatchTrainingContext(layers, data.Input, data.Output, offsets, windowLength))
+        batchResults = bc.EvaluateWeightsBatch(weights);
+
+      for (int b = 0; b < offsets.Length; b++)
+      {
+        var input = data.Input.SubMatrix(0, data.Input.RowCount, offsets[b], windowLength);
+        var output = data.Output.SubVector(offsets[b], windowLength);
+        using (var context = RNNInterop.CreateTrainingContext(layers, input, output))
+        {
+          var single = context.EvaluateWeights(weights);
+          batchResults[b].Error.ShouldBeCloseTo(single.Error, 1e-9);
+          (batchResults[b].Gradient - single.Gradient).Norm(2).ShouldBeLessThan(1e-9);
+        }
+      }
+    }
+
+    [Test]
+    public void SequencePropagationMatchesPerColumnPropagation()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      var numInputs = data.Input.RowCount;
+      var spec = new RNNSpec(numInputs, layers, QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, numInputs), -1, 1));
+      var rowWiseInputs = data.Input.ToRowWiseArray();
+      var ld = data.Input.ColumnCount;
+      const int startColumn = 7;
+      var nSteps = ld - startColumn - 3;
+
+      using (var perColumn = RNNInterop.CreatePropagationContext(spec))
+      using (var sequence = RNNInterop.CreatePropagationContext(spec))
+      {
+        var expected = Enumerable.Range(startColumn, nSteps)
+          .Select(t => RNNInterop.PropagateInput(perColumn, data.Input.Column(t).ToArray(), 1)[0]).ToArray();
+        var actual = RNNInterop.PropagateSequence(sequence, rowWiseInputs, ld, startColumn, nSteps);
+        actual.ShouldEqual(expected);
+      }
+    }
+
+    [Test]
+    public void RestoredStateReproducesPredictions()
+    {
+      var data = NNTestUtils.GetData("2004-01-01", "2004-03-01");
+      var layers = MakeLayers(8, 4);
+      var numInputs = data.Input.RowCount;
+      var spec = new RNNSpec(numInputs, layers, QuqeUtil.MakeRandomVector(RNN.GetWeightCount(layers, numInputs), -1, 1));
+      const int warmup = 20;
+      var rest = data.Input.SubMatrix(0, numInputs, warmup, data.Input.ColumnCount - warmup);
+
+      using (var rnn = new RNN(spec))
+      {
+        var fromStart = rnn.PredictSequence(data.Input);
+
+        rnn.ResetState();
+        rnn.PredictSequence(data.Input.SubMatrix(0, numInputs, 0, warmup));
+        var warmedState = rnn.SaveState();
+        rnn.PredictSequence(rest).ShouldEqual(fromStart.SubVector(warmup, rest.ColumnCount));
+
+        rnn.RestoreState(warmedState);
+        rnn.PredictSequence(rest).ShouldEqual(fromStart.SubVector(warmup, rest.ColumnCount));
+
+        rnn.ResetState();
+        rnn.PredictSequence(data.Input).ShouldEqual(fromStart);
+      }
+    }
+
+    static List<LayerSpec> MakeLayers(int layer1NodeCount, int layer2NodeCount)
+    {
+      return new List<LayerSpec> {
+        new LayerSpec(layer1NodeCount, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(layer2NodeCount, true, ActivationType.LogisticSigmoid),
+        new LayerSpec(1, false, ActivationType.Linear)
+      };
+    }
+
+    static RnnTrainResult Train(DataSet data, int layer1NodeCount, int layer2NodeCount, int epochMax, Func<bool> canceled = null)
+    {
+      var numInputs = data.Input.RowCount;
+      var layers = MakeLayers(layer1NodeCount, layer2NodeCount);
+
+      var weightCount = RNN.GetWeightCount(layers, numInputs);
+      var initialWeights = QuqeUtil.MakeRandomVector(weightCount, -1, 1);
+      return RNN.TrainSCG(layers, initialWeights, epochMax, data.Input, data.Output, canceled);
+    }
+  }
+}